@@ -0,0 +1,230 @@
+/**
+ * @file admission.hpp
+ * @brief Priority-aware admission control and load shedding
+ * @details Each neko::Priority may use a share of a concurrency limit, so Low work is shed
+ * first as load rises while Critical work keeps being admitted. The limit can optionally
+ * adapt to observed latency (AIMD). Rejections raise neko::ex::TaskRejectedError.
+ */
+#pragma once
+
+#if !defined(NEKO_SCHEMA_ENABLE_MODULE) || (NEKO_SCHEMA_ENABLE_MODULE == false)
+#include <neko/schema/types.hpp>
+#include <neko/schema/srcLoc.hpp>
+#include <neko/schema/cycles.hpp>
+#include <neko/schema/exception.hpp>
+#include <neko/schema/raise.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <utility>
+#endif // !NEKO_SCHEMA_ENABLE_MODULE
+
+/**
+ * @brief Admission control
+ * @namespace neko::admission
+ */
+namespace neko::admission {
+
+    /**
+     * @brief Admission controller settings.
+     */
+    struct Config {
+        /// Maximum number of concurrent permits
+        neko::uint32 limit = 64;
+        /// Percentage of limit each priority may fill, indexed by neko::Priority
+        std::array<neko::uint16, 4> sharePercent = {50, 75, 90, 100};
+
+        /// Adapt limit to observed latency (additive increase, multiplicative decrease)
+        bool adaptive = false;
+        /// Permits held longer than this count as overload
+        std::chrono::nanoseconds targetLatency = std::chrono::milliseconds(10);
+        neko::uint32 minLimit = 1;
+        neko::uint32 maxLimit = 1024;
+        /// Factor applied to limit on overload, at most once per targetLatency
+        double decreaseFactor = 0.9;
+    };
+
+    namespace detail {
+
+        constexpr std::size_t indexOf(neko::Priority priority) noexcept {
+            return std::min<std::size_t>(static_cast<std::size_t>(priority), 3);
+        }
+
+    } // namespace detail
+
+    class Controller;
+
+    /**
+     * @brief RAII admission permit, released on destruction.
+     * @note An empty permit (rejected admission) converts to false.
+     */
+    class Permit {
+    private:
+        Controller *owner = nullptr;
+        neko::uint64 begin = 0;
+
+        friend class Controller;
+        Permit(Controller *Owner, neko::uint64 Begin) noexcept
+            : owner(Owner), begin(Begin) {}
+
+    public:
+        Permit() noexcept = default;
+        Permit(Permit &&other) noexcept
+            : owner(std::exchange(other.owner, nullptr)), begin(other.begin) {}
+        Permit &operator=(Permit &&other) noexcept {
+            if (this != &other) {
+                release();
+                owner = std::exchange(other.owner, nullptr);
+                begin = other.begin;
+            }
+            return *this;
+        }
+        Permit(const Permit &) = delete;
+        Permit &operator=(const Permit &) = delete;
+
+        ~Permit() {
+            release();
+        }
+
+        /**
+         * @brief Release the permit early, does nothing if already released.
+         */
+        inline void release() noexcept;
+
+        explicit operator bool() const noexcept {
+            return owner != nullptr;
+        }
+    };
+
+    /**
+     * @brief Lock-free admission controller.
+     *
+     * @code
+     * neko::admission::Controller controller;
+     * if (auto permit = controller.tryAdmit(neko::Priority::Low)) {
+     *     // run the work, the permit is released at scope exit
+     * }
+     * auto permit = controller.admit(neko::Priority::High); // throws TaskRejectedError when shed
+     * @endcode
+     */
+    class Controller {
+    private:
+        Config config;
+        std::atomic<neko::uint32> limit;
+        std::atomic<neko::uint32> inFlight{0};
+        std::atomic<neko::uint32> successes{0};
+        std::atomic<neko::uint64> lastDecrease{0};
+        std::array<std::atomic<neko::uint64>, 4> rejected{};
+
+        friend class Permit;
+
+        void complete(neko::uint64 begin) noexcept {
+            inFlight.fetch_sub(1, std::memory_order_release);
+            if (begin != 0) {
+                onLatency(neko::monotonicNs() - begin);
+            }
+        }
+
+        void onLatency(neko::uint64 latency) noexcept {
+            const auto target = static_cast<neko::uint64>(config.targetLatency.count());
+            auto current = limit.load(std::memory_order_relaxed);
+            if (latency > target) {
+                // Multiplicative decrease, at most once per target window
+                const auto now = neko::monotonicNs();
+                auto last = lastDecrease.load(std::memory_order_relaxed);
+                if (now - last < target || !lastDecrease.compare_exchange_strong(last, now, std::memory_order_relaxed)) {
+                    return;
+                }
+                auto next = static_cast<neko::uint32>(static_cast<double>(current) * config.decreaseFactor);
+                next = std::clamp(std::min(next, current - (current > 0 ? 1u : 0u)), config.minLimit, config.maxLimit);
+                limit.store(next, std::memory_order_relaxed);
+                successes.store(0, std::memory_order_relaxed);
+                return;
+            }
+            // Additive increase, one step per limit successful completions
+            if (successes.fetch_add(1, std::memory_order_relaxed) + 1 >= current && current < config.maxLimit) {
+                successes.store(0, std::memory_order_relaxed);
+                limit.compare_exchange_strong(current, current + 1, std::memory_order_relaxed);
+            }
+        }
+
+    public:
+        explicit Controller(const Config &Cfg = {}) noexcept
+            : config(Cfg), limit(std::clamp(Cfg.limit, Cfg.minLimit, std::max(Cfg.minLimit, Cfg.maxLimit))) {}
+
+        Controller(const Controller &) = delete;
+        Controller &operator=(const Controller &) = delete;
+
+        /**
+         * @brief Number of permits a priority may fill under the current limit.
+         * @details The share is rounded down, only Critical keeps at least one permit. At small limits
+         * (e.g. after the adaptive limit shrank to minLimit) lower priorities are shed entirely and
+         * the remaining permits stay reserved for Critical work.
+         */
+        neko::uint32 threshold(neko::Priority priority) const noexcept {
+            const neko::uint64 share = config.sharePercent[detail::indexOf(priority)];
+            if (share == 0) {
+                return 0;
+            }
+            const auto value = limit.load(std::memory_order_relaxed) * share / 100;
+            if (detail::indexOf(priority) == detail::indexOf(neko::Priority::Critical)) {
+                return static_cast<neko::uint32>(std::max<neko::uint64>(value, 1));
+            }
+            return static_cast<neko::uint32>(value);
+        }
+
+        /**
+         * @brief Try to admit work without throwing.
+         * @param priority Priority of the work.
+         * @return A permit, empty if the work was shed.
+         */
+        [[nodiscard]] Permit tryAdmit(neko::Priority priority) noexcept {
+            const auto max = threshold(priority);
+            auto current = inFlight.load(std::memory_order_relaxed);
+            do {
+                if (current >= max) {
+                    rejected[detail::indexOf(priority)].fetch_add(1, std::memory_order_relaxed);
+                    return {};
+                }
+            } while (!inFlight.compare_exchange_weak(current, current + 1, std::memory_order_acquire, std::memory_order_relaxed));
+            return Permit(this, config.adaptive ? neko::monotonicNs() : 0);
+        }
+
+        /**
+         * @brief Admit work or reject it.
+         * @param priority Priority of the work.
+         * @param srcLoc Source location information.
+         * @return A permit.
+         * @throws neko::ex::TaskRejectedError if the work was shed.
+         */
+        [[nodiscard]] Permit admit(neko::Priority priority, const neko::SrcLocInfo &srcLoc = {}) {
+            if (auto permit = tryAdmit(priority)) {
+                return permit;
+            }
+            neko::raise<neko::ex::TaskRejectedError>("Task rejected by admission control!", srcLoc);
+        }
+
+        neko::uint32 getLimit() const noexcept {
+            return limit.load(std::memory_order_relaxed);
+        }
+        neko::uint32 getInFlight() const noexcept {
+            return inFlight.load(std::memory_order_relaxed);
+        }
+        neko::uint64 getRejected(neko::Priority priority) const noexcept {
+            return rejected[detail::indexOf(priority)].load(std::memory_order_relaxed);
+        }
+        const Config &getConfig() const noexcept {
+            return config;
+        }
+    };
+
+    inline void Permit::release() noexcept {
+        if (owner != nullptr) {
+            std::exchange(owner, nullptr)->complete(begin);
+        }
+    }
+
+} // namespace neko::admission
@@ -0,0 +1,337 @@
+/**
+ * @file config.hpp
+ * @brief Compile-time config schemas validating key/value documents
+ * @details A Schema is declared once (usually constexpr) from field() descriptions and is kept
+ * as a flat plan sorted by key. Validation is a single pass over the document's entries, each
+ * looked up by binary search, and collects every violation with its key and position.
+ * validateOrThrow raises neko::ex::RangeError or neko::ex::ConfigurationError.
+ */
+#pragma once
+
+#if !defined(NEKO_SCHEMA_ENABLE_MODULE) || (NEKO_SCHEMA_ENABLE_MODULE == false)
+#include <neko/schema/types.hpp>
+#include <neko/schema/srcLoc.hpp>
+#include <neko/schema/exception.hpp>
+#include <neko/schema/raise.hpp>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+#endif // !NEKO_SCHEMA_ENABLE_MODULE
+
+/**
+ * @brief Configuration schemas
+ * @namespace neko::config
+ */
+namespace neko::config {
+
+    /**
+     * @brief Type of a config value.
+     * @details Integer types map to the neko integer aliases and are range checked against them.
+     */
+    enum class FieldType : neko::uint8 {
+        Int8,
+        Int16,
+        Int32,
+        Int64,
+        UInt8,
+        UInt16,
+        UInt32,
+        UInt64,
+        Bool,     // true / false / 1 / 0
+        String,   // Any value
+        Priority, // Low / Normal / High / Critical
+        State,    // Completed / ActionNeeded / RetryRequired / Failed
+        SyncMode  // Sync / Async
+    };
+
+    constexpr neko::cstr toString(FieldType type) noexcept {
+        switch (type) {
+            case FieldType::Int8:
+                return "int8";
+            case FieldType::Int16:
+                return "int16";
+            case FieldType::Int32:
+                return "int32";
+            case FieldType::Int64:
+                return "int64";
+            case FieldType::UInt8:
+                return "uint8";
+            case FieldType::UInt16:
+                return "uint16";
+            case FieldType::UInt32:
+                return "uint32";
+            case FieldType::UInt64:
+                return "uint64";
+            case FieldType::Bool:
+                return "bool";
+            case FieldType::String:
+                return "string";
+            case FieldType::Priority:
+                return "Priority";
+            case FieldType::State:
+                return "State";
+            case FieldType::SyncMode:
+                return "SyncMode";
+            default:
+                return "unknown";
+        }
+    }
+
+    /**
+     * @brief Description of one config key, built with field().
+     */
+    struct Field {
+        neko::strview key;
+        FieldType type = FieldType::String;
+        bool isRequired = false;
+        bool hasRange = false;
+        neko::int64 min = 0;
+        neko::int64 max = 0;
+
+        /**
+         * @brief Mark the key as required.
+         */
+        constexpr Field required() const noexcept {
+            Field copy = *this;
+            copy.isRequired = true;
+            return copy;
+        }
+
+        /**
+         * @brief Restrict an integer value to [Min, Max], in addition to the range of its type.
+         */
+        constexpr Field range(neko::int64 Min, neko::int64 Max) const noexcept {
+            Field copy = *this;
+            copy.hasRange = true;
+            copy.min = Min;
+            copy.max = Max;
+            return copy;
+        }
+    };
+
+    /**
+     * @brief Describe a config key.
+     * @param key Key, e.g. "server.port".
+     * @param type Value type.
+     */
+    constexpr Field field(neko::strview key, FieldType type) noexcept {
+        return Field{key, type};
+    }
+
+    /**
+     * @brief A key/value pair of a config document.
+     * @note key and value usually point into the document text, pos locates the entry in it.
+     */
+    struct Entry {
+        neko::strview key;
+        neko::strview value;
+        neko::TextPos pos{};
+    };
+
+    /**
+     * @brief A schema violation.
+     */
+    struct Violation {
+        /// Key of the offending entry or of the missing field
+        std::string path;
+        std::string message;
+        /// Position of the offending entry, unknown for missing keys
+        neko::TextPos pos{};
+        /// RangeError for values out of range, ConfigurationError otherwise
+        neko::ex::ErrorKind kind = neko::ex::ErrorKind::ConfigurationError;
+    };
+
+    namespace detail {
+
+        template <std::integral T>
+        bool checkInteger(const Field &field, neko::strview value, Violation &violation) {
+            T parsed{};
+            const auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), parsed);
+            if (ptr != value.data() + value.size() || (ec != std::errc{} && ec != std::errc::result_out_of_range) || value.empty()) {
+                violation.message = std::string("Expected ") + toString(field.type);
+                return false;
+            }
+            if (ec == std::errc::result_out_of_range) {
+                violation.message = std::string("Value out of range for ") + toString(field.type);
+                violation.kind = neko::ex::ErrorKind::RangeError;
+                return false;
+            }
+            if (field.hasRange && (std::cmp_less(parsed, field.min) || std::cmp_greater(parsed, field.max))) {
+                violation.message = "Value out of range [" + std::to_string(field.min) + ", " + std::to_string(field.max) + "]";
+                violation.kind = neko::ex::ErrorKind::RangeError;
+                return false;
+            }
+            return true;
+        }
+
+        template <std::size_t N>
+        bool checkName(const std::array<neko::strview, N> &names, const Field &field, neko::strview value, Violation &violation) {
+            if (std::find(names.begin(), names.end(), value) != names.end()) {
+                return true;
+            }
+            violation.message = std::string("Expected ") + toString(field.type);
+            return false;
+        }
+
+        inline bool checkValue(const Field &field, neko::strview value, Violation &violation) {
+            switch (field.type) {
+                case FieldType::Int8:
+                    return checkInteger<neko::int8>(field, value, violation);
+                case FieldType::Int16:
+                    return checkInteger<neko::int16>(field, value, violation);
+                case FieldType::Int32:
+                    return checkInteger<neko::int32>(field, value, violation);
+                case FieldType::Int64:
+                    return checkInteger<neko::int64>(field, value, violation);
+                case FieldType::UInt8:
+                    return checkInteger<neko::uint8>(field, value, violation);
+                case FieldType::UInt16:
+                    return checkInteger<neko::uint16>(field, value, violation);
+                case FieldType::UInt32:
+                    return checkInteger<neko::uint32>(field, value, violation);
+                case FieldType::UInt64:
+                    return checkInteger<neko::uint64>(field, value, violation);
+                case FieldType::Bool:
+                    return checkName(std::array<neko::strview, 4>{"true", "false", "1", "0"}, field, value, violation);
+                case FieldType::Priority:
+                    return checkName(std::array<neko::strview, 4>{"Low", "Normal", "High", "Critical"}, field, value, violation);
+                case FieldType::State:
+                    return checkName(std::array<neko::strview, 4>{"Completed", "ActionNeeded", "RetryRequired", "Failed"}, field, value, violation);
+                case FieldType::SyncMode:
+                    return checkName(std::array<neko::strview, 2>{"Sync", "Async"}, field, value, violation);
+                case FieldType::String:
+                default:
+                    return true;
+            }
+        }
+
+    } // namespace detail
+
+    /**
+     * @brief A validation plan: the fields of a schema sorted by key.
+     *
+     * @code
+     * using neko::config::FieldType;
+     * constexpr neko::config::Schema schema{
+     *     neko::config::field("server.port", FieldType::UInt16).required().range(1024, 65535),
+     *     neko::config::field("server.host", FieldType::String).required(),
+     *     neko::config::field("queue.priority", FieldType::Priority),
+     * };
+     * schema.validateOrThrow(entries); // throws RangeError / ConfigurationError
+     * @endcode
+     */
+    template <std::size_t N>
+    class Schema {
+    private:
+        std::array<Field, N> fields;
+
+    public:
+        /**
+         * @brief Build the plan, in a constant expression when declared constexpr.
+         * @throws neko::ex::ArgumentError on duplicate keys (a compile error in a constant expression).
+         */
+        constexpr explicit Schema(const std::same_as<Field> auto &...list)
+            : fields{list...} {
+            std::sort(fields.begin(), fields.end(), [](const Field &a, const Field &b) { return a.key < b.key; });
+            for (std::size_t i = 1; i < N; ++i) {
+                if (fields[i - 1].key == fields[i].key) {
+                    neko::raise<neko::ex::ArgumentError>("Duplicate key in config schema!");
+                }
+            }
+        }
+
+        /**
+         * @brief Find the field of a key.
+         * @return Index of the field, N if the key is not part of the schema.
+         */
+        constexpr std::size_t find(neko::strview key) const noexcept {
+            const auto it = std::lower_bound(fields.begin(), fields.end(), key, [](const Field &a, neko::strview k) { return a.key < k; });
+            return (it != fields.end() && it->key == key) ? static_cast<std::size_t>(it - fields.begin()) : N;
+        }
+
+        constexpr std::size_t size() const noexcept { return N; }
+        constexpr const Field &operator[](std::size_t index) const noexcept { return fields[index]; }
+
+        /**
+         * @brief Validate a document in one pass.
+         * @param entries Entries of the document.
+         * @param out Violations are appended to it, in document order then missing keys in key order.
+         * @param allowUnknown Accept keys that are not part of the schema.
+         * @return Number of violations appended.
+         */
+        std::size_t validate(std::span<const Entry> entries, std::vector<Violation> &out, bool allowUnknown = false) const {
+            const std::size_t before = out.size();
+            std::array<bool, N> seen{};
+            for (const auto &entry : entries) {
+                const auto index = find(entry.key);
+                if (index == N) {
+                    if (!allowUnknown) {
+                        out.push_back(Violation{std::string(entry.key), "Unknown key", entry.pos});
+                    }
+                    continue;
+                }
+                if (seen[index]) {
+                    out.push_back(Violation{std::string(entry.key), "Duplicate key", entry.pos});
+                    continue;
+                }
+                seen[index] = true;
+                Violation violation{{}, {}, entry.pos};
+                if (!detail::checkValue(fields[index], entry.value, violation)) {
+                    violation.path = std::string(entry.key);
+                    out.push_back(std::move(violation));
+                }
+            }
+            for (std::size_t i = 0; i < N; ++i) {
+                if (fields[i].isRequired && !seen[i]) {
+                    out.push_back(Violation{std::string(fields[i].key), "Missing required key"});
+                }
+            }
+            return out.size() - before;
+        }
+
+        /**
+         * @brief Validate a document and raise on any violation.
+         * @param entries Entries of the document.
+         * @param srcLoc Source location information.
+         * @param allowUnknown Accept keys that are not part of the schema.
+         * @throws neko::ex::RangeError if every violation is a value out of range.
+         * @throws neko::ex::ConfigurationError otherwise, listing every violation.
+         */
+        void validateOrThrow(std::span<const Entry> entries, const neko::SrcLocInfo &srcLoc = {}, bool allowUnknown = false) const {
+            std::vector<Violation> violations;
+            if (validate(entries, violations, allowUnknown) == 0) {
+                return;
+            }
+            std::string msg = "Invalid config:";
+            bool allRange = true;
+            for (const auto &violation : violations) {
+                msg += ' ';
+                msg += violation.path;
+                msg += ": ";
+                msg += violation.message;
+                if (violation.pos.hasInfo()) {
+                    msg += " (line " + std::to_string(violation.pos.getLine()) + ')';
+                }
+                msg += ';';
+                allRange = allRange && violation.kind == neko::ex::ErrorKind::RangeError;
+            }
+            msg.pop_back();
+            if (allRange) {
+                neko::raise<neko::ex::RangeError>(msg, srcLoc);
+            }
+            neko::raise<neko::ex::ConfigurationError>(msg, srcLoc);
+        }
+    };
+
+    template <typename... Fields>
+    Schema(const Fields &...) -> Schema<sizeof...(Fields)>;
+
+} // namespace neko::config
@@ -0,0 +1,204 @@
+/**
+ * @file configReader.hpp
+ * @brief Zero-copy key/value config reader
+ * @details Documents are memory-mapped and tokenized into neko::config::Entry slices pointing
+ * straight into the mapping. Line breaks and delimiters are found with memchr, which the C library
+ * vectorizes. Malformed lines raise neko::ex::ParseError with their byte offset, line and column.
+ *
+ * Format, one entry per line:
+ * @code
+ * # comment (also ; comment)
+ * server.host = localhost
+ * server.port = 8080
+ * @endcode
+ * Keys and values are trimmed of spaces and tabs, line breaks may be "\n" or "\r\n".
+ */
+#pragma once
+
+#if !defined(NEKO_SCHEMA_ENABLE_MODULE) || (NEKO_SCHEMA_ENABLE_MODULE == false)
+#include <neko/schema/types.hpp>
+#include <neko/schema/srcLoc.hpp>
+#include <neko/schema/exception.hpp>
+#include <neko/schema/raise.hpp>
+#include <neko/schema/mappedFile.hpp>
+#include <neko/schema/config.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <string>
+#include <vector>
+#endif // !NEKO_SCHEMA_ENABLE_MODULE
+
+namespace neko::config {
+
+    /**
+     * @brief An entry copied out of its document.
+     */
+    struct OwnedEntry {
+        std::string key;
+        std::string value;
+        neko::TextPos pos{};
+    };
+
+    namespace detail {
+
+        constexpr bool isBlank(char c) noexcept {
+            return c == ' ' || c == '\t';
+        }
+
+        constexpr neko::strview trim(neko::strview text) noexcept {
+            while (!text.empty() && isBlank(text.front())) {
+                text.remove_prefix(1);
+            }
+            while (!text.empty() && isBlank(text.back())) {
+                text.remove_suffix(1);
+            }
+            return text;
+        }
+
+        [[noreturn]] inline void raiseAt(neko::strview source, const neko::TextPos &pos, neko::cstr msg, const neko::SrcLocInfo &srcLoc) {
+            if (source.empty()) {
+                neko::raise<neko::ex::ParseError>(pos, msg, srcLoc);
+            }
+            neko::raise<neko::ex::ParseError>(pos, std::string(source) + ": " + msg, srcLoc);
+        }
+
+        inline std::size_t tokenize(neko::strview text, std::vector<Entry> &out, neko::strview source, const neko::SrcLocInfo &srcLoc) {
+            const std::size_t before = out.size();
+            const char *const base = text.data();
+            const char *const end = base + text.size();
+            const char *lineStart = base;
+            neko::uint32 line = 0;
+
+            const auto posOf = [&](const char *at) {
+                return neko::TextPos{static_cast<neko::uint64>(at - base), line, static_cast<neko::uint32>(at - lineStart + 1)};
+            };
+
+            while (lineStart < end) {
+                ++line;
+                const auto *newline = static_cast<const char *>(std::memchr(lineStart, '\n', static_cast<std::size_t>(end - lineStart)));
+                const char *next = newline ? newline + 1 : end;
+                const char *lineEnd = newline ? newline : end;
+                if (lineEnd != lineStart && lineEnd[-1] == '\r') {
+                    --lineEnd;
+                }
+
+                const char *first = lineStart;
+                if (line == 1 && text.starts_with("\xEF\xBB\xBF")) {
+                    first += 3; // UTF-8 byte order mark
+                }
+                while (first != lineEnd && isBlank(*first)) {
+                    ++first;
+                }
+                if (first == lineEnd || *first == '#' || *first == ';') {
+                    lineStart = next;
+                    continue;
+                }
+
+                const auto *equals = static_cast<const char *>(std::memchr(first, '=', static_cast<std::size_t>(lineEnd - first)));
+                if (equals == nullptr) {
+                    raiseAt(source, posOf(first), "Expected '='", srcLoc);
+                }
+                const auto key = trim(neko::strview(first, static_cast<std::size_t>(equals - first)));
+                if (key.empty()) {
+                    raiseAt(source, posOf(equals), "Empty key", srcLoc);
+                }
+                if (const auto blank = key.find_first_of(" \t"); blank != neko::strview::npos) {
+                    raiseAt(source, posOf(first + blank), "Invalid character in key", srcLoc);
+                }
+                const auto value = trim(neko::strview(equals + 1, static_cast<std::size_t>(lineEnd - equals - 1)));
+                out.push_back(Entry{key, value, posOf(first)});
+                lineStart = next;
+            }
+            return out.size() - before;
+        }
+
+    } // namespace detail
+
+    /**
+     * @brief Tokenize key/value text without copying it.
+     * @param text Document text, must outlive the entries.
+     * @param out Entries are appended to it, their key and value point into text.
+     * @param srcLoc Source location information.
+     * @return Number of entries appended.
+     * @throws neko::ex::ParseError on a malformed line.
+     */
+    inline std::size_t tokenize(neko::strview text, std::vector<Entry> &out, const neko::SrcLocInfo &srcLoc = {}) {
+        return detail::tokenize(text, out, {}, srcLoc);
+    }
+
+    /**
+     * @brief A memory-mapped key/value document.
+     * @details Entries point into the mapping, which lives as long as the document (moves keep them valid).
+     *
+     * @code
+     * auto document = neko::config::Document::load("tenant.conf");
+     * schema.validateOrThrow(document.getEntries());
+     * if (const auto *port = document.find("server.port")) { ... port->value ... }
+     * @endcode
+     */
+    class Document {
+    private:
+        MappedFile mapping;
+        std::vector<Entry> entries;
+
+    public:
+        Document() = default;
+
+        /**
+         * @brief Map and tokenize a file.
+         * @param path File path.
+         * @param srcLoc Source location information.
+         * @throws neko::ex::FileError if the file cannot be mapped, with its error code.
+         * @throws neko::ex::ParseError on a malformed line, the message is prefixed with the path.
+         */
+        static Document load(const std::string &path, const neko::SrcLocInfo &srcLoc = {}) {
+            Document document;
+            document.mapping = MappedFile::openRead(path, srcLoc);
+            detail::tokenize(document.mapping.view(), document.entries, path, srcLoc);
+            return document;
+        }
+
+        std::span<const Entry> getEntries() const noexcept {
+            return entries;
+        }
+
+        std::size_t size() const noexcept {
+            return entries.size();
+        }
+
+        /**
+         * @brief Whole mapped text of the document.
+         */
+        neko::strview getText() const noexcept {
+            return mapping.view();
+        }
+
+        /**
+         * @brief Find the first entry of a key.
+         * @return The entry, nullptr if the key is absent.
+         */
+        const Entry *find(neko::strview key) const noexcept {
+            for (const auto &entry : entries) {
+                if (entry.key == key) {
+                    return &entry;
+                }
+            }
+            return nullptr;
+        }
+
+        /**
+         * @brief Copy the entries into owned strings, e.g. to keep them after the document is closed.
+         */
+        std::vector<OwnedEntry> toOwned() const {
+            std::vector<OwnedEntry> owned;
+            owned.reserve(entries.size());
+            for (const auto &entry : entries) {
+                owned.push_back(OwnedEntry{std::string(entry.key), std::string(entry.value), entry.pos});
+            }
+            return owned;
+        }
+    };
+
+} // namespace neko::config
@@ -0,0 +1,56 @@
+/**
+ * @file cycles.hpp
+ * @brief Clocks shared by the measuring modules
+ * @details readCycles reads the time stamp counter on x86 and the virtual counter on AArch64,
+ * and falls back to steady clock nanoseconds elsewhere. Its values are only meaningful as differences.
+ * monotonicNs times spans and latencies, wallClockNs timestamps records meant to outlive the process.
+ */
+#pragma once
+
+#if !defined(NEKO_SCHEMA_ENABLE_MODULE) || (NEKO_SCHEMA_ENABLE_MODULE == false)
+#include <neko/schema/types.hpp>
+
+#include <chrono>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#endif // !NEKO_SCHEMA_ENABLE_MODULE
+
+namespace neko {
+
+    /**
+     * @brief Monotonic nanoseconds, for durations.
+     */
+    inline neko::uint64 monotonicNs() noexcept {
+        return static_cast<neko::uint64>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    /**
+     * @brief Nanoseconds since the Unix epoch, for timestamps.
+     */
+    inline neko::uint64 wallClockNs() noexcept {
+        return static_cast<neko::uint64>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+    }
+
+    /**
+     * @brief Read the cycle counter.
+     * @return Cycles (or nanoseconds on targets without an accessible counter).
+     */
+    inline neko::uint64 readCycles() noexcept {
+#if (defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))) || defined(__x86_64__) || defined(__i386__)
+        return static_cast<neko::uint64>(__rdtsc());
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+        neko::uint64 value;
+        asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+        return value;
+#else
+        return monotonicNs();
+#endif
+    }
+
+} // namespace neko
@@ -7,9 +7,61 @@
 #if !defined(NEKO_SCHEMA_ENABLE_MODULE) || (NEKO_SCHEMA_ENABLE_MODULE == false)
 #include <neko/schema/types.hpp>
 #include <neko/schema/srcLoc.hpp>
+#include <neko/schema/cycles.hpp>
 
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
 #include <exception>
+#include <new>
 #include <string>
+#include <system_error>
+#include <utility>
+#endif
+
+/**
+ * @brief Build mode of the exception classes.
+ * @details Header-only by default. With NEKO_SCHEMA_COMPILED (set by the Neko::Schema::Compiled target),
+ * every class declares an out-of-line destructor defined in src/exception.cpp. That destructor is the key function,
+ * so the vtables and typeinfo are emitted once in the library instead of weakly in every translation unit.
+ */
+#if defined(NEKO_SCHEMA_COMPILED) && defined(NEKO_SCHEMA_SHARED)
+    #if defined(_WIN32)
+        #if defined(NEKO_SCHEMA_EXPORTS)
+            #define NEKO_SCHEMA_API __declspec(dllexport)
+        #else
+            #define NEKO_SCHEMA_API __declspec(dllimport)
+        #endif
+    #else
+        #define NEKO_SCHEMA_API __attribute__((visibility("default")))
+    #endif
+#else
+    #define NEKO_SCHEMA_API
+#endif
+
+/**
+ * @brief Linkage of the process-wide hook registries (throwHook.hpp, throwSites.hpp).
+ * @details Inline when header-only. With NEKO_SCHEMA_COMPILED the registries are defined once in src/exception.cpp
+ * (which sets NEKO_SCHEMA_COMPILED_SOURCE) and exported, so every module of a program shares them.
+ */
+#if defined(NEKO_SCHEMA_COMPILED)
+    #define NEKO_SCHEMA_REGISTRY_API NEKO_SCHEMA_API
+#else
+    #define NEKO_SCHEMA_REGISTRY_API inline
+#endif
+
+#if defined(NEKO_SCHEMA_COMPILED)
+    // Declaring the destructor would suppress the implicit moves, so they are defaulted explicitly
+    #define NEKO_SCHEMA_KEY_FUNCTION(Name)             \
+    public:                                            \
+        Name(const Name &) = default;                  \
+        Name(Name &&) = default;                       \
+        Name &operator=(const Name &) = default;       \
+        Name &operator=(Name &&) = default;            \
+        ~Name() override;
+#else
+    #define NEKO_SCHEMA_KEY_FUNCTION(Name)
 #endif
 
 /**
@@ -18,32 +70,263 @@
  */
 namespace neko::ex {
 
+    /**
+     * @brief Identifies the concrete error class, usable without RTTI or exceptions.
+     */
+    enum class ErrorKind : neko::uint8 {
+        Exception,
+        ProgramExit,
+        LogicError,
+        ArgumentError,
+        RangeError,
+        NotSupported,
+        InvalidState,
+        AssertionFailure,
+        DuplicateError,
+        RuntimeError,
+        ConfigurationError,
+        ParseError,
+        ConcurrencyError,
+        TaskRejectedError,
+        PermissionDeniedError,
+        TimeoutError,
+        SystemError,
+        FileError,
+        NetworkError,
+        DatabaseError,
+        ExternalDependencyError
+    };
+
+    /**
+     * @brief Get the class name of an error kind.
+     * @return Name as a C-string.
+     */
+    constexpr neko::cstr toString(ErrorKind kind) noexcept {
+        switch (kind) {
+            case ErrorKind::Exception:
+                return "Exception";
+            case ErrorKind::ProgramExit:
+                return "ProgramExit";
+            case ErrorKind::LogicError:
+                return "LogicError";
+            case ErrorKind::ArgumentError:
+                return "ArgumentError";
+            case ErrorKind::RangeError:
+                return "RangeError";
+            case ErrorKind::NotSupported:
+                return "NotSupported";
+            case ErrorKind::InvalidState:
+                return "InvalidState";
+            case ErrorKind::AssertionFailure:
+                return "AssertionFailure";
+            case ErrorKind::DuplicateError:
+                return "DuplicateError";
+            case ErrorKind::RuntimeError:
+                return "RuntimeError";
+            case ErrorKind::ConfigurationError:
+                return "ConfigurationError";
+            case ErrorKind::ParseError:
+                return "ParseError";
+            case ErrorKind::ConcurrencyError:
+                return "ConcurrencyError";
+            case ErrorKind::TaskRejectedError:
+                return "TaskRejectedError";
+            case ErrorKind::PermissionDeniedError:
+                return "PermissionDeniedError";
+            case ErrorKind::TimeoutError:
+                return "TimeoutError";
+            case ErrorKind::SystemError:
+                return "SystemError";
+            case ErrorKind::FileError:
+                return "FileError";
+            case ErrorKind::NetworkError:
+                return "NetworkError";
+            case ErrorKind::DatabaseError:
+                return "DatabaseError";
+            case ErrorKind::ExternalDependencyError:
+                return "ExternalDependencyError";
+            default:
+                return "Unknown";
+        }
+    }
+
+    /**
+     * @brief Callback invoked whenever a neko::ex::Exception is constructed.
+     * @see neko/schema/throwHook.hpp for registration.
+     */
+    using ThrowHook = void (*)(ErrorKind kind, neko::strview message, const neko::SrcLocInfo &srcLoc, void *userData) noexcept;
+
+    namespace detail {
+
+        struct ThrowHookEntry {
+            ThrowHook hook = nullptr;
+            void *userData = nullptr;
+            neko::uint64 id = 0;
+        };
+
+        /**
+         * @brief Called when a stamped exception is destroyed, with the cycles elapsed since its construction.
+         */
+        using ReleaseHook = void (*)(ErrorKind kind, const neko::SrcLocInfo &srcLoc, neko::uint64 cycles) noexcept;
+
+        /**
+         * @brief Immutable snapshot of the installed hooks, replaced as a whole on registration.
+         */
+        struct ThrowHookList {
+            const ThrowHookEntry *entries = nullptr;
+            std::size_t count = 0;
+            /// Release hook (at most one, see throwSites.hpp), exceptions are only stamped while it is set
+            ReleaseHook release = nullptr;
+            /// Constructions currently calling these hooks, awaited by removeThrowHook
+            mutable std::atomic<neko::uint32> readers{0};
+        };
+
+        /**
+         * @brief Installed hooks, nullptr when there are neither throw hooks nor a release hook.
+         * @note Read with a relaxed load so the unhooked path is a single load and branch.
+         */
+#if defined(NEKO_SCHEMA_COMPILED)
+        // Defined in src/exception.cpp: an inline variable would be duplicated per module with hidden visibility
+        extern NEKO_SCHEMA_API std::atomic<const ThrowHookList *> throwHooks;
+#else
+        inline std::atomic<const ThrowHookList *> throwHooks{nullptr};
+#endif
+
+        /**
+         * @brief Call the installed throw hooks.
+         * @return True if the exception should be stamped for the release hook.
+         */
+        inline bool notifyThrowHooks(ErrorKind kind, neko::strview message, const neko::SrcLocInfo &srcLoc) noexcept {
+            // The relaxed load of the caller only decided the branch, reload to acquire the snapshot
+            const auto *list = throwHooks.load(std::memory_order_acquire);
+            if (list != nullptr && list->count == 0) {
+                return list->release != nullptr;
+            }
+            while (list != nullptr) {
+                // Register as a reader, then check the snapshot is still current: either removeThrowHook
+                // sees this reader and waits for it, or this reader sees the replacement and retries
+                list->readers.fetch_add(1, std::memory_order_seq_cst);
+                if (throwHooks.load(std::memory_order_seq_cst) == list) {
+                    for (std::size_t i = 0; i < list->count; ++i) {
+                        list->entries[i].hook(kind, message, srcLoc, list->entries[i].userData);
+                    }
+                    list->readers.fetch_sub(1, std::memory_order_release);
+                    return list->release != nullptr;
+                }
+                list->readers.fetch_sub(1, std::memory_order_relaxed);
+                list = throwHooks.load(std::memory_order_acquire);
+            }
+            return false;
+        }
+
+        /**
+         * @brief Construction time of an exception in cycles, 0 if not stamped.
+         * @note Copies start unstamped, so only the original object reports its release.
+         */
+        struct CostStamp {
+            neko::uint64 begin = 0;
+
+            CostStamp() noexcept = default;
+            CostStamp(const CostStamp &) noexcept {}
+            CostStamp &operator=(const CostStamp &) noexcept {
+                return *this;
+            }
+        };
+
+        /**
+         * @brief Message built on first use and published with a CAS, so concurrent readers all see one buffer.
+         * @note Copies start empty and build their own, keeping the owner's copy and move noexcept.
+         */
+        class LazyMessage {
+        private:
+            mutable std::atomic<char *> text{nullptr};
+
+        public:
+            LazyMessage() noexcept = default;
+            LazyMessage(const LazyMessage &) noexcept {}
+            LazyMessage &operator=(const LazyMessage &) noexcept {
+                delete[] text.exchange(nullptr, std::memory_order_relaxed);
+                return *this;
+            }
+            ~LazyMessage() {
+                delete[] text.load(std::memory_order_relaxed);
+            }
+
+            /**
+             * @brief Get the published message, nullptr if none was published yet.
+             */
+            neko::cstr get() const noexcept {
+                return text.load(std::memory_order_acquire);
+            }
+
+            /**
+             * @brief Publish Msg unless another thread published first.
+             * @return The published message, nullptr if the buffer could not be allocated.
+             */
+            neko::cstr publish(neko::strview Msg) const noexcept {
+                char *buffer = new (std::nothrow) char[Msg.size() + 1];
+                if (buffer == nullptr) {
+                    return nullptr;
+                }
+                std::memcpy(buffer, Msg.data(), Msg.size());
+                buffer[Msg.size()] = '\0';
+                char *expected = nullptr;
+                if (text.compare_exchange_strong(expected, buffer, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                    return buffer;
+                }
+                delete[] buffer;
+                return expected;
+            }
+        };
+
+    } // namespace detail
+
     /**
      * @brief Base error class extending std::exception and std::nested_exception.
      *
      * Provides basic error handling functionality for all derived error types.
      * Stores error message and extension info
      */
-    class Exception : public std::exception, public std::nested_exception {
+    class NEKO_SCHEMA_API Exception : public std::exception, public std::nested_exception {
     private:
         std::string msg;
         neko::SrcLocInfo srcLoc;
+        ErrorKind errKind;
+        detail::CostStamp stamp;
 
     public:
+        static constexpr ErrorKind kind = ErrorKind::Exception;
+
+        Exception(const Exception &) = default;
+        Exception(Exception &&) = default;
+        Exception &operator=(const Exception &) = default;
+        Exception &operator=(Exception &&) = default;
+
+        /**
+         * @brief Report the cost of a stamped exception to the release hook.
+         */
+#if defined(NEKO_SCHEMA_COMPILED)
+        ~Exception() override;
+#else
+        ~Exception() override {
+            releaseStamp();
+        }
+#endif
+
         /**
          * @brief Construct an Exception with a message.
          * @param Msg Error message.
          * @param SrcLoc Source location information.
          */
         explicit Exception(const std::string &Msg, const neko::SrcLocInfo &SrcLoc = {}) noexcept
-            : msg(Msg), srcLoc(SrcLoc) {}
+            : Exception(kind, Msg, SrcLoc) {}
         /**
          * @brief Construct an Exception with a C-string message.
          * @param Msg Error message.
          * @param SrcLoc Source location information.
          */
         explicit Exception(neko::cstr Msg, const neko::SrcLocInfo &SrcLoc = {}) noexcept
-            : msg(Msg ? Msg : ""), srcLoc(SrcLoc) {}
+            : Exception(kind, Msg ? Msg : "", SrcLoc) {}
 
         /**
          * @brief Get the error message.
@@ -97,175 +380,492 @@ namespace neko::ex {
         const std::string &getMessage() const noexcept {
             return msg;
         }
+        /**
+         * @brief Get the kind of the most derived neko::ex class.
+         * @return Error kind.
+         */
+        ErrorKind getKind() const noexcept {
+            return errKind;
+        }
+
+    protected:
+        void releaseStamp() const noexcept {
+            if (stamp.begin != 0) [[unlikely]] {
+                // Snapshots are never freed, so the current one is safe to read here
+                const auto *list = detail::throwHooks.load(std::memory_order_acquire);
+                if (list != nullptr && list->release != nullptr) {
+                    list->release(errKind, srcLoc, neko::readCycles() - stamp.begin);
+                }
+            }
+        }
+
+        /**
+         * @brief Construct an Exception of the given kind, used by derived classes.
+         * @param Kind Kind of the most derived class.
+         * @param Msg Error message.
+         * @param SrcLoc Source location information.
+         */
+        Exception(ErrorKind Kind, std::string Msg, const neko::SrcLocInfo &SrcLoc) noexcept
+            : msg(std::move(Msg)), srcLoc(SrcLoc), errKind(Kind) {
+            if (detail::throwHooks.load(std::memory_order_relaxed) != nullptr) [[unlikely]] {
+                if (detail::notifyThrowHooks(errKind, msg, srcLoc)) {
+                    stamp.begin = neko::readCycles();
+                }
+            }
+        }
     };
 
     /**
      * @brief Exception for program termination or exit.
      */
-    class ProgramExit : public Exception {
+    class NEKO_SCHEMA_API ProgramExit : public Exception {
     public:
+        static constexpr ErrorKind kind = ErrorKind::ProgramExit;
+
         explicit ProgramExit(const std::string &Msg = "Program exited!", const neko::SrcLocInfo &SrcLoc = {}) noexcept
-            : Exception(Msg, SrcLoc) {}
+            : Exception(kind, Msg, SrcLoc) {}
+
+        NEKO_SCHEMA_KEY_FUNCTION(ProgramExit)
+
+    protected:
+        ProgramExit(ErrorKind Kind, std::string Msg, const neko::SrcLocInfo &SrcLoc) noexcept
+            : Exception(Kind, std::move(Msg), SrcLoc) {}
     };
 
     // ---------------------------------------------------------------------
     // Logic-layer errors
     // ---------------------------------------------------------------------
 
-    class LogicError : public Exception {
+    class NEKO_SCHEMA_API LogicError : public Exception {
     public:
+        static constexpr ErrorKind kind = ErrorKind::LogicError;
+
         explicit LogicError(const std::string &Msg = "Logic error!", const neko::SrcLocInfo &SrcLoc = {}) noexcept
-            : Exception(Msg, SrcLoc) {}
+            : Exception(kind, Msg, SrcLoc) {}
         explicit LogicError(neko::cstr Msg, const neko::SrcLocInfo &SrcLoc = {}) noexcept
-            : Exception(Msg ? Msg : "Logic error!", SrcLoc) {}
+            : Exception(kind, Msg ? Msg : "Logic error!", SrcLoc) {}
+
+        NEKO_SCHEMA_KEY_FUNCTION(LogicError)
+
+    protected:
+        LogicError(ErrorKind Kind, std::string Msg, const neko::SrcLocInfo &SrcLoc) noexcept
+            : Exception(Kind, std::move(Msg), SrcLoc) {}
     };
 
-    class ArgumentError : public LogicError {
+    class NEKO_SCHEMA_API ArgumentError : public LogicError {
     public:
+        static constexpr ErrorKind kind = ErrorKind::ArgumentError;
+
         explicit ArgumentError(const std::string &Msg = "Invalid argument!", const neko::SrcLocInfo &SrcLoc = {}) noexcept
-            : LogicError(Msg, SrcLoc) {}
+            : LogicError(kind, Msg, SrcLoc) {}
         explicit ArgumentError(neko::cstr Msg, const neko::SrcLocInfo &SrcLoc = {}) noexcept
-            : LogicError(Msg ? Msg : "Invalid argument!", SrcLoc) {}
+            : LogicError(kind, Msg ? Msg : "Invalid argument!", SrcLoc) {}
+
+        NEKO_SCHEMA_KEY_FUNCTION(ArgumentError)
+
+    protected:
+        ArgumentError(ErrorKind Kind, std::string Msg, const neko::SrcLocInfo &SrcLoc) noexcept
+            : LogicError(Kind, std::move(Msg), SrcLoc) {}
     };
 
-    class RangeError : public ArgumentError {
+    class NEKO_SCHEMA_API RangeError : public ArgumentError {
     public:
+        static constexpr ErrorKind kind = ErrorKind::RangeError;
+
         explicit RangeError(const std::string &Msg = "Out of range!", const neko::SrcLocInfo &SrcLoc = {}) noexcept
-            : ArgumentError(Msg, SrcLoc) {}
+            : ArgumentError(kind, Msg, SrcLoc) {}
         explicit RangeError(neko::cstr Msg, const neko::SrcLocInfo &SrcLoc = {}) noexcept
-            : ArgumentError(Msg ? Msg : "Out of range!", SrcLoc) {}
+            : ArgumentError(kind, Msg ? Msg : "Out of range!", SrcLoc) {}
+
+        NEKO_SCHEMA_KEY_FUNCTION(RangeError)
+
+    protected:
+        RangeError(ErrorKind Kind, std::string Msg, const neko::SrcLocInfo &SrcLoc) noexcept
+            : ArgumentError(Kind, std::move(Msg), SrcLoc) {}
     };
 
-    class NotSupported : public LogicError {
+    class NEKO_SCHEMA_API NotSupported : public LogicError {
     public:
+        static constexpr ErrorKind kind = ErrorKind::NotSupported;
+
         explicit NotSupported(const std::string &Msg = "Not supported!", const neko::SrcLocInfo &SrcLoc = {}) noexcept
-            : LogicError(Msg, SrcLoc) {}
+            : LogicError(kind, Msg, SrcLoc) {}
         explicit NotSupported(neko::cstr Msg, const neko::SrcLocInfo &SrcLoc = {}) noexcept
-            : LogicError(Msg ? Msg : "Not supported!", SrcLoc) {}
+            : LogicError(kind, Msg ? Msg : "Not supported!", SrcLoc) {}
+
+        NEKO_SCHEMA_KEY_FUNCTION(NotSupported)
+
+    protected:
+        NotSupported(ErrorKind Kind, std::string Msg, const neko::SrcLocInfo &SrcLoc) noexcept
+            : LogicError(Kind, std::move(Msg), SrcLoc) {}
     };
 
-    class InvalidState : public LogicError {
+    class NEKO_SCHEMA_API InvalidState : public LogicError {
     public:
+        static constexpr ErrorKind kind = ErrorKind::InvalidState;
+
         explicit InvalidState(const std::string &Msg = "Invalid state!", const neko::SrcLocInfo &SrcLoc = {}) noexcept
-            : LogicError(Msg, SrcLoc) {}
+            : LogicError(kind, Msg, SrcLoc) {}
         explicit InvalidState(neko::cstr Msg, const neko::SrcLocInfo &SrcLoc = {}) noexcept
-            : LogicError(Msg ? Msg : "Invalid state!", SrcLoc) {}
+            : LogicError(kind, Msg ? Msg : "Invalid state!", SrcLoc) {}
+
+        NEKO_SCHEMA_KEY_FUNCTION(InvalidState)
+
+    protected:
+        InvalidState(ErrorKind Kind, std::string Msg, const neko::SrcLocInfo &SrcLoc) noexcept
+            : LogicError(Kind, std::move(Msg), SrcLoc) {}
     };
 
-    class AssertionFailure : public LogicError {
+    class NEKO_SCHEMA_API AssertionFailure : public LogicError {
     public:
+        static constexpr ErrorKind kind = ErrorKind::AssertionFailure;
+
         explicit AssertionFailure(const std::string &Msg = "Assertion failed!", const neko::SrcLocInfo &SrcLoc = {}) noexcept
-            : LogicError(Msg, SrcLoc) {}
+            : LogicError(kind, Msg, SrcLoc) {}
         explicit AssertionFailure(neko::cstr Msg, const neko::SrcLocInfo &SrcLoc = {}) noexcept
-            : LogicError(Msg ? Msg : "Assertion failed!", SrcLoc) {}
+            : LogicError(kind, Msg ? Msg : "Assertion failed!", SrcLoc) {}
+
+        NEKO_SCHEMA_KEY_FUNCTION(AssertionFailure)
+
+    protected:
+        AssertionFailure(ErrorKind Kind, std::string Msg, const neko::SrcLocInfo &SrcLoc) noexcept
+            : LogicError(Kind, std::move(Msg), SrcLoc) {}
     };
 
-    class DuplicateError : public LogicError {
+    class NEKO_SCHEMA_API DuplicateError : public LogicError {
     public:
+        static constexpr ErrorKind kind = ErrorKind::DuplicateError;
+
         explicit DuplicateError(const std::string &Msg = "Object already exists!", const neko::SrcLocInfo &SrcLoc = {}) noexcept
-            : LogicError(Msg, SrcLoc) {}
+            : LogicError(kind, Msg, SrcLoc) {}
         explicit DuplicateError(neko::cstr Msg, const neko::SrcLocInfo &SrcLoc = {}) noexcept
-            : LogicError(Msg ? Msg : "Object already exists!", SrcLoc) {}
+            : LogicError(kind, Msg ? Msg : "Object already exists!", SrcLoc) {}
+
+        NEKO_SCHEMA_KEY_FUNCTION(DuplicateError)
+
+    protected:
+        DuplicateError(ErrorKind Kind, std::string Msg, const neko::SrcLocInfo &SrcLoc) noexcept
+            : LogicError(Kind, std::move(Msg), SrcLoc) {}
     };
 
     // ---------------------------------------------------------------------
     // Runtime-layer errors
     // ---------------------------------------------------------------------
 
-    class RuntimeError : public Exception {
+    class NEKO_SCHEMA_API RuntimeError : public Exception {
     public:
+        static constexpr ErrorKind kind = ErrorKind::RuntimeError;
+
         explicit RuntimeError(const std::string &Msg = "Runtime error!", const neko::SrcLocInfo &SrcLoc = {}) noexcept
-            : Exception(Msg, SrcLoc) {}
+            : Exception(kind, Msg, SrcLoc) {}
         explicit RuntimeError(neko::cstr Msg, const neko::SrcLocInfo &SrcLoc = {}) noexcept
-            : Exception(Msg ? Msg : "Runtime error!", SrcLoc) {}
+            : Exception(kind, Msg ? Msg : "Runtime error!", SrcLoc) {}
+
+        NEKO_SCHEMA_KEY_FUNCTION(RuntimeError)
+
+    protected:
+        RuntimeError(ErrorKind Kind, std::string Msg, const neko::SrcLocInfo &SrcLoc) noexcept
+            : Exception(Kind, std::move(Msg), SrcLoc) {}
     };
 
-    class ConfigurationError : public RuntimeError {
+    class NEKO_SCHEMA_API ConfigurationError : public RuntimeError {
     public:
+        static constexpr ErrorKind kind = ErrorKind::ConfigurationError;
+
         explicit ConfigurationError(const std::string &Msg = "Configuration error!", const neko::SrcLocInfo &SrcLoc = {}) noexcept
-            : RuntimeError(Msg, SrcLoc) {}
+            : RuntimeError(kind, Msg, SrcLoc) {}
         explicit ConfigurationError(neko::cstr Msg, const neko::SrcLocInfo &SrcLoc = {}) noexcept
-            : RuntimeError(Msg ? Msg : "Configuration error!", SrcLoc) {}
+            : RuntimeError(kind, Msg ? Msg : "Configuration error!", SrcLoc) {}
+
+        NEKO_SCHEMA_KEY_FUNCTION(ConfigurationError)
+
+    protected:
+        ConfigurationError(ErrorKind Kind, std::string Msg, const neko::SrcLocInfo &SrcLoc) noexcept
+            : RuntimeError(Kind, std::move(Msg), SrcLoc) {}
     };
 
-    class ParseError : public RuntimeError {
+    /**
+     * @brief Error raised while parsing text input.
+     *
+     * Optionally carries the position in the input (byte offset, line and column)
+     * as structured fields, so callers do not have to encode it into the message.
+     */
+    class NEKO_SCHEMA_API ParseError : public RuntimeError {
+    private:
+        neko::TextPos textPos;
+
     public:
+        static constexpr ErrorKind kind = ErrorKind::ParseError;
+
         explicit ParseError(const std::string &Msg = "Parse error!", const neko::SrcLocInfo &SrcLoc = {}) noexcept
-            : RuntimeError(Msg, SrcLoc) {}
+            : RuntimeError(kind, Msg, SrcLoc) {}
         explicit ParseError(neko::cstr Msg, const neko::SrcLocInfo &SrcLoc = {}) noexcept
-            : RuntimeError(Msg ? Msg : "Parse error!", SrcLoc) {}
+            : RuntimeError(kind, Msg ? Msg : "Parse error!", SrcLoc) {}
+        /**
+         * @brief Construct a ParseError with the position in the input.
+         * @param Pos Position in the parsed input.
+         * @param Msg Error message.
+         * @param SrcLoc Source location information.
+         */
+        ParseError(const neko::TextPos &Pos, const std::string &Msg, const neko::SrcLocInfo &SrcLoc = {}) noexcept
+            : RuntimeError(kind, Msg, SrcLoc), textPos(Pos) {}
+        ParseError(const neko::TextPos &Pos, neko::cstr Msg, const neko::SrcLocInfo &SrcLoc = {}) noexcept
+            : RuntimeError(kind, Msg ? Msg : "Parse error!", SrcLoc), textPos(Pos) {}
+
+        /**
+         * @brief Check if the position in the input is available.
+         * @return True if the position is present.
+         */
+        bool hasTextPos() const noexcept {
+            return textPos.hasInfo();
+        }
+        /**
+         * @brief Get the position in the input where parsing failed.
+         * @return Reference to TextPos.
+         */
+        const neko::TextPos &getTextPos() const noexcept {
+            return textPos;
+        }
+
+        NEKO_SCHEMA_KEY_FUNCTION(ParseError)
+
+    protected:
+        ParseError(ErrorKind Kind, std::string Msg, const neko::SrcLocInfo &SrcLoc) noexcept
+            : RuntimeError(Kind, std::move(Msg), SrcLoc) {}
     };
 
-    class ConcurrencyError : public RuntimeError {
+    class NEKO_SCHEMA_API ConcurrencyError : public RuntimeError {
     public:
+        static constexpr ErrorKind kind = ErrorKind::ConcurrencyError;
+
         explicit ConcurrencyError(const std::string &Msg = "Concurrency error!", const neko::SrcLocInfo &SrcLoc = {}) noexcept
-            : RuntimeError(Msg, SrcLoc) {}
+            : RuntimeError(kind, Msg, SrcLoc) {}
         explicit ConcurrencyError(neko::cstr Msg, const neko::SrcLocInfo &SrcLoc = {}) noexcept
-            : RuntimeError(Msg ? Msg : "Concurrency error!", SrcLoc) {}
+            : RuntimeError(kind, Msg ? Msg : "Concurrency error!", SrcLoc) {}
+
+        NEKO_SCHEMA_KEY_FUNCTION(ConcurrencyError)
+
+    protected:
+        ConcurrencyError(ErrorKind Kind, std::string Msg, const neko::SrcLocInfo &SrcLoc) noexcept
+            : RuntimeError(Kind, std::move(Msg), SrcLoc) {}
     };
 
-    class TaskRejectedError : public ConcurrencyError {
+    class NEKO_SCHEMA_API TaskRejectedError : public ConcurrencyError {
     public:
+        static constexpr ErrorKind kind = ErrorKind::TaskRejectedError;
+
         explicit TaskRejectedError(const std::string &Msg = "Task rejected!", const neko::SrcLocInfo &SrcLoc = {}) noexcept
-            : ConcurrencyError(Msg, SrcLoc) {}
+            : ConcurrencyError(kind, Msg, SrcLoc) {}
         explicit TaskRejectedError(neko::cstr Msg, const neko::SrcLocInfo &SrcLoc = {}) noexcept
-            : ConcurrencyError(Msg ? Msg : "Task rejected!", SrcLoc) {}
+            : ConcurrencyError(kind, Msg ? Msg : "Task rejected!", SrcLoc) {}
+
+        NEKO_SCHEMA_KEY_FUNCTION(TaskRejectedError)
+
+    protected:
+        TaskRejectedError(ErrorKind Kind, std::string Msg, const neko::SrcLocInfo &SrcLoc) noexcept
+            : ConcurrencyError(Kind, std::move(Msg), SrcLoc) {}
     };
 
-    class PermissionDeniedError : public RuntimeError {
+    class NEKO_SCHEMA_API PermissionDeniedError : public RuntimeError {
     public:
+        static constexpr ErrorKind kind = ErrorKind::PermissionDeniedError;
+
         explicit PermissionDeniedError(const std::string &Msg = "Permission denied!", const neko::SrcLocInfo &SrcLoc = {}) noexcept
-            : RuntimeError(Msg, SrcLoc) {}
+            : RuntimeError(kind, Msg, SrcLoc) {}
         explicit PermissionDeniedError(neko::cstr Msg, const neko::SrcLocInfo &SrcLoc = {}) noexcept
-            : RuntimeError(Msg ? Msg : "Permission denied!", SrcLoc) {}
+            : RuntimeError(kind, Msg ? Msg : "Permission denied!", SrcLoc) {}
+
+        NEKO_SCHEMA_KEY_FUNCTION(PermissionDeniedError)
+
+    protected:
+        PermissionDeniedError(ErrorKind Kind, std::string Msg, const neko::SrcLocInfo &SrcLoc) noexcept
+            : RuntimeError(Kind, std::move(Msg), SrcLoc) {}
     };
 
-    class TimeoutError : public RuntimeError {
+    class NEKO_SCHEMA_API TimeoutError : public RuntimeError {
     public:
+        static constexpr ErrorKind kind = ErrorKind::TimeoutError;
+
         explicit TimeoutError(const std::string &Msg = "Timeout!", const neko::SrcLocInfo &SrcLoc = {}) noexcept
-            : RuntimeError(Msg, SrcLoc) {}
+            : RuntimeError(kind, Msg, SrcLoc) {}
         explicit TimeoutError(neko::cstr Msg, const neko::SrcLocInfo &SrcLoc = {}) noexcept
-            : RuntimeError(Msg ? Msg : "Timeout!", SrcLoc) {}
+            : RuntimeError(kind, Msg ? Msg : "Timeout!", SrcLoc) {}
+
+        NEKO_SCHEMA_KEY_FUNCTION(TimeoutError)
+
+    protected:
+        TimeoutError(ErrorKind Kind, std::string Msg, const neko::SrcLocInfo &SrcLoc) noexcept
+            : RuntimeError(Kind, std::move(Msg), SrcLoc) {}
     };
 
-    class SystemError : public RuntimeError {
+    /**
+     * @brief Error reported by the operating system or an external service.
+     * @details May carry a std::error_code. When it does, the code's message is looked up lazily on the first what()
+     * call and appended to the message, so paths that only branch on getCode() never format it.
+     */
+    class NEKO_SCHEMA_API SystemError : public RuntimeError {
+    private:
+        std::error_code code;
+        detail::LazyMessage fullMsg; // Built by the first what() call when code is set
+
     public:
+        static constexpr ErrorKind kind = ErrorKind::SystemError;
+
         explicit SystemError(const std::string &Msg = "System error!", const neko::SrcLocInfo &SrcLoc = {}) noexcept
-            : RuntimeError(Msg, SrcLoc) {}
+            : RuntimeError(kind, Msg, SrcLoc) {}
         explicit SystemError(neko::cstr Msg, const neko::SrcLocInfo &SrcLoc = {}) noexcept
-            : RuntimeError(Msg ? Msg : "System error!", SrcLoc) {}
+            : RuntimeError(kind, Msg ? Msg : "System error!", SrcLoc) {}
+        /**
+         * @brief Construct a SystemError carrying an error code.
+         * @param Code Error code.
+         * @param Msg Optional context, what() returns "Msg: code message" or only the code message.
+         * @param SrcLoc Source location information.
+         */
+        explicit SystemError(std::error_code Code, const std::string &Msg = {}, const neko::SrcLocInfo &SrcLoc = {}) noexcept
+            : RuntimeError(kind, Msg, SrcLoc), code(Code) {}
+
+        /**
+         * @brief Capture errno as a generic error code, without formatting its message.
+         * @param SrcLoc Source location information.
+         */
+        static SystemError fromErrno(const neko::SrcLocInfo &SrcLoc = {}) noexcept {
+            return SystemError(std::error_code(errno, std::generic_category()), {}, SrcLoc);
+        }
+
+        /**
+         * @brief Get the error message, including the error code message if a code is set.
+         * @note Safe to call concurrently: racing first calls may each build the message, but only one is published.
+         */
+        neko::cstr what() const noexcept override {
+            const neko::cstr msg = RuntimeError::what();
+            if (!code) {
+                return msg;
+            }
+            if (const neko::cstr built = fullMsg.get()) {
+                return built;
+            }
+#if defined(__cpp_exceptions) || defined(_CPPUNWIND)
+            try {
+                const neko::cstr built = fullMsg.publish(*msg != '\0' ? std::string(msg) + ": " + code.message() : code.message());
+                return built != nullptr ? built : msg;
+            } catch (...) {
+                return msg;
+            }
+#else
+            const neko::cstr built = fullMsg.publish(*msg != '\0' ? std::string(msg) + ": " + code.message() : code.message());
+            return built != nullptr ? built : msg;
+#endif
+        }
+
+        /**
+         * @brief Check if an error code is set.
+         */
+        bool hasCode() const noexcept {
+            return static_cast<bool>(code);
+        }
+
+        /**
+         * @brief Get the error code, empty if none was given.
+         */
+        const std::error_code &getCode() const noexcept {
+            return code;
+        }
+
+        NEKO_SCHEMA_KEY_FUNCTION(SystemError)
+
+    protected:
+        SystemError(ErrorKind Kind, std::string Msg, const neko::SrcLocInfo &SrcLoc) noexcept
+            : RuntimeError(Kind, std::move(Msg), SrcLoc) {}
+        SystemError(ErrorKind Kind, std::error_code Code, std::string Msg, const neko::SrcLocInfo &SrcLoc) noexcept
+            : RuntimeError(Kind, std::move(Msg), SrcLoc), code(Code) {}
     };
 
-    class FileError : public SystemError {
+    class NEKO_SCHEMA_API FileError : public SystemError {
     public:
+        static constexpr ErrorKind kind = ErrorKind::FileError;
+
         explicit FileError(const std::string &Msg = "File error!", const neko::SrcLocInfo &SrcLoc = {}) noexcept
-            : SystemError(Msg, SrcLoc) {}
+            : SystemError(kind, Msg, SrcLoc) {}
         explicit FileError(neko::cstr Msg, const neko::SrcLocInfo &SrcLoc = {}) noexcept
-            : SystemError(Msg ? Msg : "File error!", SrcLoc) {}
+            : SystemError(kind, Msg ? Msg : "File error!", SrcLoc) {}
+        explicit FileError(std::error_code Code, const std::string &Msg = {}, const neko::SrcLocInfo &SrcLoc = {}) noexcept
+            : SystemError(kind, Code, Msg, SrcLoc) {}
+
+        static FileError fromErrno(const neko::SrcLocInfo &SrcLoc = {}) noexcept {
+            return FileError(std::error_code(errno, std::generic_category()), {}, SrcLoc);
+        }
+
+        NEKO_SCHEMA_KEY_FUNCTION(FileError)
+
+    protected:
+        FileError(ErrorKind Kind, std::string Msg, const neko::SrcLocInfo &SrcLoc) noexcept
+            : SystemError(Kind, std::move(Msg), SrcLoc) {}
+        FileError(ErrorKind Kind, std::error_code Code, std::string Msg, const neko::SrcLocInfo &SrcLoc) noexcept
+            : SystemError(Kind, Code, std::move(Msg), SrcLoc) {}
     };
 
-    class NetworkError : public SystemError {
+    class NEKO_SCHEMA_API NetworkError : public SystemError {
     public:
+        static constexpr ErrorKind kind = ErrorKind::NetworkError;
+
         explicit NetworkError(const std::string &Msg = "Network error!", const neko::SrcLocInfo &SrcLoc = {}) noexcept
-            : SystemError(Msg, SrcLoc) {}
+            : SystemError(kind, Msg, SrcLoc) {}
         explicit NetworkError(neko::cstr Msg, const neko::SrcLocInfo &SrcLoc = {}) noexcept
-            : SystemError(Msg ? Msg : "Network error!", SrcLoc) {}
+            : SystemError(kind, Msg ? Msg : "Network error!", SrcLoc) {}
+        explicit NetworkError(std::error_code Code, const std::string &Msg = {}, const neko::SrcLocInfo &SrcLoc = {}) noexcept
+            : SystemError(kind, Code, Msg, SrcLoc) {}
+
+        static NetworkError fromErrno(const neko::SrcLocInfo &SrcLoc = {}) noexcept {
+            return NetworkError(std::error_code(errno, std::generic_category()), {}, SrcLoc);
+        }
+
+        NEKO_SCHEMA_KEY_FUNCTION(NetworkError)
+
+    protected:
+        NetworkError(ErrorKind Kind, std::string Msg, const neko::SrcLocInfo &SrcLoc) noexcept
+            : SystemError(Kind, std::move(Msg), SrcLoc) {}
+        NetworkError(ErrorKind Kind, std::error_code Code, std::string Msg, const neko::SrcLocInfo &SrcLoc) noexcept
+            : SystemError(Kind, Code, std::move(Msg), SrcLoc) {}
     };
 
-    class DatabaseError : public SystemError {
+    class NEKO_SCHEMA_API DatabaseError : public SystemError {
     public:
+        static constexpr ErrorKind kind = ErrorKind::DatabaseError;
+
         explicit DatabaseError(const std::string &Msg = "Database error!", const neko::SrcLocInfo &SrcLoc = {}) noexcept
-            : SystemError(Msg, SrcLoc) {}
+            : SystemError(kind, Msg, SrcLoc) {}
         explicit DatabaseError(neko::cstr Msg, const neko::SrcLocInfo &SrcLoc = {}) noexcept
-            : SystemError(Msg ? Msg : "Database error!", SrcLoc) {}
+            : SystemError(kind, Msg ? Msg : "Database error!", SrcLoc) {}
+        explicit DatabaseError(std::error_code Code, const std::string &Msg = {}, const neko::SrcLocInfo &SrcLoc = {}) noexcept
+            : SystemError(kind, Code, Msg, SrcLoc) {}
+
+        static DatabaseError fromErrno(const neko::SrcLocInfo &SrcLoc = {}) noexcept {
+            return DatabaseError(std::error_code(errno, std::generic_category()), {}, SrcLoc);
+        }
+
+        NEKO_SCHEMA_KEY_FUNCTION(DatabaseError)
+
+    protected:
+        DatabaseError(ErrorKind Kind, std::string Msg, const neko::SrcLocInfo &SrcLoc) noexcept
+            : SystemError(Kind, std::move(Msg), SrcLoc) {}
+        DatabaseError(ErrorKind Kind, std::error_code Code, std::string Msg, const neko::SrcLocInfo &SrcLoc) noexcept
+            : SystemError(Kind, Code, std::move(Msg), SrcLoc) {}
     };
 
-    class ExternalDependencyError : public SystemError {
+    class NEKO_SCHEMA_API ExternalDependencyError : public SystemError {
     public:
+        static constexpr ErrorKind kind = ErrorKind::ExternalDependencyError;
+
         explicit ExternalDependencyError(const std::string &Msg = "External dependency error!", const neko::SrcLocInfo &SrcLoc = {}) noexcept
-            : SystemError(Msg, SrcLoc) {}
+            : SystemError(kind, Msg, SrcLoc) {}
         explicit ExternalDependencyError(neko::cstr Msg, const neko::SrcLocInfo &SrcLoc = {}) noexcept
-            : SystemError(Msg ? Msg : "External dependency error!", SrcLoc) {}
+            : SystemError(kind, Msg ? Msg : "External dependency error!", SrcLoc) {}
+
+        NEKO_SCHEMA_KEY_FUNCTION(ExternalDependencyError)
+
+    protected:
+        ExternalDependencyError(ErrorKind Kind, std::string Msg, const neko::SrcLocInfo &SrcLoc) noexcept
+            : SystemError(Kind, std::move(Msg), SrcLoc) {}
     };
 
     // ---------------------------------------------------------------------
@@ -0,0 +1,192 @@
+/**
+ * @file format.hpp
+ * @brief std::formatter specializations for NekoSchema types
+ * @details Exceptions, SrcLocInfo and the enums of types.hpp are written straight into the
+ * output iterator, without building intermediate strings.
+ *
+ * Format specs:
+ * - SrcLocInfo: `{}` file:line, `{:f}` file:line in func.
+ * - Exception and subclasses: `{}` Kind: message, `{:f}` adds the source location,
+ *   `c` (e.g. `{:c}`, `{:fc}`) appends the nested cause chain.
+ * - State, Priority, SyncMode, ErrorKind: the name, accepting the std::string_view specs (fill, align, width).
+ *
+ * Only available when the standard library provides <format> (NEKO_SCHEMA_HAS_FORMAT is 1).
+ * Without exceptions, an invalid spec parsed at run time is reported through neko::raise as an ArgumentError
+ * and nested causes are only reported as unknown.
+ */
+#pragma once
+
+#if !defined(NEKO_SCHEMA_ENABLE_MODULE) || (NEKO_SCHEMA_ENABLE_MODULE == false)
+#include <neko/schema/types.hpp>
+#include <neko/schema/srcLoc.hpp>
+#include <neko/schema/exception.hpp>
+#include <neko/schema/raise.hpp>
+
+#include <version>
+#if defined(__cpp_lib_format)
+#include <concepts>
+#include <exception>
+#include <format>
+#include <string_view>
+#endif
+#endif // !NEKO_SCHEMA_ENABLE_MODULE
+
+#if defined(__cpp_lib_format)
+#define NEKO_SCHEMA_HAS_FORMAT 1
+#else
+#define NEKO_SCHEMA_HAS_FORMAT 0
+#endif
+
+#if NEKO_SCHEMA_HAS_FORMAT
+
+namespace neko::detail {
+
+    /**
+     * @brief Parsed spec of the SrcLocInfo and Exception formatters.
+     */
+    struct FormatSpec {
+        bool full = false;
+        bool causes = false;
+
+        constexpr auto parse(std::format_parse_context &ctx, bool allowCauses) {
+            auto it = ctx.begin();
+            for (; it != ctx.end() && *it != '}'; ++it) {
+                if (*it == 's') {
+                    full = false;
+                } else if (*it == 'f') {
+                    full = true;
+                } else if (*it == 'c' && allowCauses) {
+                    causes = true;
+                } else {
+#if defined(NEKO_SCHEMA_NO_EXCEPTIONS) || (!defined(__cpp_exceptions) && !defined(_CPPUNWIND))
+                    // Tested directly too: module partitions do not see the macro of raise.hpp
+                    // Not a constant expression either, so format string checks still fail to compile
+                    neko::raise<neko::ex::ArgumentError>("Invalid format spec for a NekoSchema type");
+#else
+                    throw std::format_error("Invalid format spec for a NekoSchema type");
+#endif
+                }
+            }
+            return it;
+        }
+    };
+
+    constexpr std::string_view orEmpty(neko::cstr text) noexcept {
+        return text ? std::string_view(text) : std::string_view();
+    }
+
+    template <typename Out>
+    Out formatSrcLoc(Out out, const neko::SrcLocInfo &srcLoc, bool full) {
+        out = std::format_to(out, "{}:{}", orEmpty(srcLoc.getFile()), srcLoc.getLine());
+        if (full && srcLoc.getFunc() != nullptr) {
+            out = std::format_to(out, " in {}", srcLoc.getFunc());
+        }
+        return out;
+    }
+
+    template <typename Out>
+    Out formatException(Out out, const neko::ex::Exception &e, bool full) {
+        out = std::format_to(out, "{}: {}", neko::ex::toString(e.getKind()), orEmpty(e.what()));
+        if (full && e.hasSrcLocInfo()) {
+            out = std::format_to(out, " (at ");
+            out = formatSrcLoc(out, e.getSrcLoc(), true);
+            *out++ = ')';
+        }
+        return out;
+    }
+
+    template <typename Out>
+    Out formatCauses(Out out, std::exception_ptr cause, bool full) {
+#if defined(__cpp_exceptions) || defined(_CPPUNWIND)
+        // Bounded, a nested chain is never expected to be this deep
+        for (int depth = 0; cause && depth < 32; ++depth) {
+            out = std::format_to(out, "; caused by: ");
+            try {
+                std::rethrow_exception(cause);
+            } catch (const neko::ex::Exception &e) {
+                out = formatException(out, e, full);
+                cause = e.nested_ptr();
+            } catch (const std::exception &e) {
+                out = std::format_to(out, "{}", orEmpty(e.what()));
+                const auto *nested = dynamic_cast<const std::nested_exception *>(&e);
+                cause = nested ? nested->nested_ptr() : nullptr;
+            } catch (...) {
+                out = std::format_to(out, "unknown exception");
+                cause = nullptr;
+            }
+        }
+#else
+        // The cause cannot be inspected without rethrowing it
+        (void)full;
+        if (cause) {
+            out = std::format_to(out, "; caused by: unknown exception");
+        }
+#endif
+        return out;
+    }
+
+    /**
+     * @brief Formats an enum through its toString name.
+     */
+    template <typename Enum>
+    struct EnumFormatter : std::formatter<std::string_view, char> {
+        template <typename FormatContext>
+        auto format(Enum value, FormatContext &ctx) const {
+            using neko::toString;
+            using neko::ex::toString;
+            return std::formatter<std::string_view, char>::format(toString(value), ctx);
+        }
+    };
+
+} // namespace neko::detail
+
+namespace std {
+
+    template <>
+    struct formatter<neko::SrcLocInfo, char> {
+        neko::detail::FormatSpec spec;
+
+        constexpr auto parse(std::format_parse_context &ctx) {
+            return spec.parse(ctx, false);
+        }
+
+        template <typename FormatContext>
+        auto format(const neko::SrcLocInfo &srcLoc, FormatContext &ctx) const {
+            return neko::detail::formatSrcLoc(ctx.out(), srcLoc, spec.full);
+        }
+    };
+
+    template <typename T>
+        requires std::derived_from<T, neko::ex::Exception>
+    struct formatter<T, char> {
+        neko::detail::FormatSpec spec;
+
+        constexpr auto parse(std::format_parse_context &ctx) {
+            return spec.parse(ctx, true);
+        }
+
+        template <typename FormatContext>
+        auto format(const neko::ex::Exception &e, FormatContext &ctx) const {
+            auto out = neko::detail::formatException(ctx.out(), e, spec.full);
+            if (spec.causes) {
+                out = neko::detail::formatCauses(out, e.nested_ptr(), spec.full);
+            }
+            return out;
+        }
+    };
+
+    template <>
+    struct formatter<neko::State, char> : neko::detail::EnumFormatter<neko::State> {};
+
+    template <>
+    struct formatter<neko::Priority, char> : neko::detail::EnumFormatter<neko::Priority> {};
+
+    template <>
+    struct formatter<neko::SyncMode, char> : neko::detail::EnumFormatter<neko::SyncMode> {};
+
+    template <>
+    struct formatter<neko::ex::ErrorKind, char> : neko::detail::EnumFormatter<neko::ex::ErrorKind> {};
+
+} // namespace std
+
+#endif // NEKO_SCHEMA_HAS_FORMAT
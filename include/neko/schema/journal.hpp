@@ -0,0 +1,360 @@
+/**
+ * @file journal.hpp
+ * @brief Crash-safe error journal in a memory-mapped ring file
+ * @details Once attached, every neko::ex::Exception construction appends a compact fixed-size
+ * record (kind, timestamp, source location, truncated message) to a shared file mapping.
+ * Slots are reserved with a single atomic increment and the append path makes no system call,
+ * so the records are in the page cache, and survive the process, as soon as they are written.
+ * neko::journal::read decodes the ring afterwards for post-mortems.
+ */
+#pragma once
+
+#if !defined(NEKO_SCHEMA_ENABLE_MODULE) || (NEKO_SCHEMA_ENABLE_MODULE == false)
+#include <neko/schema/types.hpp>
+#include <neko/schema/srcLoc.hpp>
+#include <neko/schema/cycles.hpp>
+#include <neko/schema/exception.hpp>
+#include <neko/schema/raise.hpp>
+#include <neko/schema/throwHook.hpp>
+#include <neko/schema/mappedFile.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <system_error>
+#include <vector>
+#endif // !NEKO_SCHEMA_ENABLE_MODULE
+
+/**
+ * @brief Error journal
+ * @namespace neko::journal
+ */
+namespace neko::journal {
+
+    /**
+     * @brief A decoded journal record.
+     */
+    struct Record {
+        /// Position in the journal, increasing across the whole file lifetime
+        neko::uint64 seq = 0;
+        /// System clock nanoseconds since the Unix epoch
+        neko::uint64 timestampNs = 0;
+        neko::ex::ErrorKind kind = neko::ex::ErrorKind::Exception;
+        neko::uint32 line = 0;
+        /// Tail of the file path
+        std::string file;
+        /// Head of the function name
+        std::string func;
+        /// Head of the message
+        std::string message;
+        /// True if the message was cut to fit the slot
+        bool truncated = false;
+    };
+
+    namespace detail {
+
+        inline constexpr char magic[8] = {'N', 'E', 'K', 'O', 'J', 'R', 'N', 'L'};
+        inline constexpr neko::uint32 version = 1;
+
+        struct FileHeader {
+            char magic[8];
+            neko::uint32 version;
+            neko::uint32 slotSize;
+            neko::uint64 slotCount;
+            neko::uint64 nextSeq; // Only accessed through std::atomic_ref
+            neko::uint64 dropped; // Only accessed through std::atomic_ref
+            neko::uint64 reserved[3];
+        };
+        static_assert(sizeof(FileHeader) == 64);
+
+        struct Slot {
+            static constexpr std::size_t fileCapacity = 55;
+            static constexpr std::size_t funcCapacity = 56;
+            static constexpr std::size_t messageCapacity = 120;
+            static constexpr neko::uint8 truncatedFlag = 1;
+
+            neko::uint64 commit; // seq + 1 once the record is complete, 0 if empty, busy while it is written
+            neko::uint64 timestampNs;
+            neko::uint32 line;
+            neko::uint8 kind;
+            neko::uint8 flags;
+            neko::uint8 fileLen;
+            neko::uint8 funcLen;
+            neko::uint8 messageLen;
+            char file[fileCapacity];
+            char func[funcCapacity];
+            char message[messageCapacity];
+        };
+        static_assert(sizeof(Slot) == 256);
+
+        inline constexpr neko::uint64 busy = ~neko::uint64{0};
+
+        inline neko::uint8 copyHead(char *dest, std::size_t capacity, neko::strview text) noexcept {
+            const auto n = std::min(text.size(), capacity);
+            std::memcpy(dest, text.data(), n);
+            return static_cast<neko::uint8>(n);
+        }
+
+        inline neko::uint8 copyTail(char *dest, std::size_t capacity, neko::strview text) noexcept {
+            return copyHead(dest, capacity, text.substr(text.size() - std::min(text.size(), capacity)));
+        }
+
+        inline std::size_t mappingSize(std::size_t slotCount) noexcept {
+            return sizeof(FileHeader) + slotCount * sizeof(Slot);
+        }
+
+        inline bool isValid(const FileHeader &header) noexcept {
+            return std::memcmp(header.magic, magic, sizeof(magic)) == 0 && header.version == version && header.slotSize == sizeof(Slot);
+        }
+
+        /**
+         * @brief Check the slot count of a valid header against the size of its file.
+         * @details Compares without computing mappingSize, which a corrupt slot count would overflow.
+         */
+        inline bool fitsIn(const FileHeader &header, std::size_t fileSize) noexcept {
+            return header.slotCount != 0 && fileSize >= sizeof(FileHeader) &&
+                   header.slotCount <= (fileSize - sizeof(FileHeader)) / sizeof(Slot);
+        }
+
+        inline std::vector<Record> decode(const FileHeader &header, const Slot *slots) {
+            std::vector<Record> records;
+            for (std::size_t i = 0; i < header.slotCount; ++i) {
+                // Seqlock read: the record is consistent if its commit marker did not change while copying
+                std::atomic_ref<neko::uint64> commit(const_cast<neko::uint64 &>(slots[i].commit));
+                const auto before = commit.load(std::memory_order_acquire);
+                if (before == 0 || before == busy) {
+                    continue;
+                }
+                Slot copy;
+                std::memcpy(&copy, &slots[i], sizeof(Slot));
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (commit.load(std::memory_order_relaxed) != before) {
+                    continue;
+                }
+                Record record;
+                record.seq = before - 1;
+                record.timestampNs = copy.timestampNs;
+                record.kind = static_cast<neko::ex::ErrorKind>(copy.kind);
+                record.line = copy.line;
+                record.file.assign(copy.file, std::min<std::size_t>(copy.fileLen, Slot::fileCapacity));
+                record.func.assign(copy.func, std::min<std::size_t>(copy.funcLen, Slot::funcCapacity));
+                record.message.assign(copy.message, std::min<std::size_t>(copy.messageLen, Slot::messageCapacity));
+                record.truncated = (copy.flags & Slot::truncatedFlag) != 0;
+                records.push_back(std::move(record));
+            }
+            std::sort(records.begin(), records.end(), [](const Record &a, const Record &b) { return a.seq < b.seq; });
+            return records;
+        }
+
+    } // namespace detail
+
+    /**
+     * @brief Error journal writing into a memory-mapped ring file.
+     *
+     * @code
+     * // Usually a process-lifetime object
+     * static neko::journal::Journal journal("errors.journal");
+     * journal.attach(); // every neko::ex::Exception is now journaled
+     *
+     * // Later, e.g. in a post-mortem tool
+     * for (const auto &record : neko::journal::read("errors.journal")) { ... }
+     * @endcode
+     *
+     * @note Reopening a journal keeps its records and its slot count. A non-empty file that is not
+     * a journal is never overwritten. When the ring wraps onto a slot still being written, the newer
+     * record is dropped (counted by dropped()), a record is never partially overwritten.
+     */
+    class Journal {
+    private:
+        MappedFile mapping;
+        detail::FileHeader *header = nullptr;
+        detail::Slot *slots = nullptr;
+        neko::ex::ThrowHookId hookId = 0;
+
+        static void onThrow(neko::ex::ErrorKind kind, neko::strview msg, const neko::SrcLocInfo &srcLoc, void *self) noexcept {
+            static_cast<Journal *>(self)->append(kind, msg, srcLoc);
+        }
+
+    public:
+        static constexpr std::size_t defaultSlotCount = 4096;
+
+        /**
+         * @brief Open a journal file, or create it if it is missing or empty.
+         * @param path File path.
+         * @param slotCount Number of records kept before the oldest is overwritten, for a new file.
+         * An existing journal keeps its own slot count, see capacity().
+         * @param srcLoc Source location information.
+         * @throws neko::ex::ArgumentError if slotCount is 0.
+         * @throws neko::ex::FileError if the file cannot be mapped.
+         * @throws neko::ex::ParseError if the file is not empty and not a valid journal, it is left untouched.
+         */
+        explicit Journal(const std::string &path, std::size_t slotCount = defaultSlotCount, const neko::SrcLocInfo &srcLoc = {}) {
+            if (slotCount == 0) {
+                neko::raise<neko::ex::ArgumentError>("Journal slot count must be greater than 0!", srcLoc);
+            }
+            std::error_code ec;
+            const auto existingSize = std::filesystem::file_size(path, ec);
+            const bool existing = !ec && existingSize > 0;
+            if (existing) {
+                // Inspect the file read-only first, so a foreign file is never grown or written
+                const auto current = MappedFile::openRead(path, srcLoc);
+                const auto *found = reinterpret_cast<const detail::FileHeader *>(current.data());
+                if (current.size() < sizeof(detail::FileHeader) || !detail::isValid(*found)) {
+                    neko::raise<neko::ex::ParseError>("Not an error journal: " + path, srcLoc);
+                }
+                if (!detail::fitsIn(*found, current.size())) {
+                    neko::raise<neko::ex::ParseError>("Corrupt error journal: " + path, srcLoc);
+                }
+                slotCount = static_cast<std::size_t>(found->slotCount);
+            }
+            mapping = MappedFile::openWrite(path, detail::mappingSize(slotCount), srcLoc);
+            header = reinterpret_cast<detail::FileHeader *>(mapping.data());
+            slots = reinterpret_cast<detail::Slot *>(mapping.data() + sizeof(detail::FileHeader));
+            if (!existing) {
+                std::memset(mapping.data(), 0, mapping.size());
+                std::memcpy(header->magic, detail::magic, sizeof(detail::magic));
+                header->version = detail::version;
+                header->slotSize = sizeof(detail::Slot);
+                header->slotCount = slotCount;
+                return;
+            }
+            if (!detail::isValid(*header) || header->slotCount != slotCount) {
+                // Replaced between the inspection and the mapping
+                mapping.unmap();
+                neko::raise<neko::ex::ParseError>("Not an error journal: " + path, srcLoc);
+            }
+            // Slots left busy by a writer that crashed mid-record are only partially written
+            for (std::size_t i = 0; i < slotCount; ++i) {
+                if (slots[i].commit == detail::busy) {
+                    slots[i].commit = 0;
+                }
+            }
+        }
+
+        Journal(const Journal &) = delete;
+        Journal &operator=(const Journal &) = delete;
+
+        /**
+         * @brief Detach and unmap. Records written so far stay in the file.
+         * @note Detaching waits for concurrent exception constructions still journaling,
+         * so the mapping is never used after it is unmapped.
+         */
+        ~Journal() {
+            detach();
+        }
+
+        /**
+         * @brief Journal every neko::ex::Exception construction, does nothing if already attached.
+         */
+        void attach() {
+            if (hookId == 0) {
+                hookId = neko::ex::addThrowHook(&Journal::onThrow, this);
+            }
+        }
+
+        /**
+         * @brief Stop journaling exceptions, does nothing if not attached.
+         * @details Returns once no exception construction is still calling into the journal.
+         */
+        void detach() {
+            if (hookId != 0) {
+                neko::ex::removeThrowHook(hookId);
+                hookId = 0;
+            }
+        }
+
+        bool isAttached() const noexcept {
+            return hookId != 0;
+        }
+
+        /**
+         * @brief Append a record, lock-free and without system calls.
+         * @param kind Error kind.
+         * @param msg Message, truncated to the slot capacity.
+         * @param srcLoc Source location information.
+         */
+        void append(neko::ex::ErrorKind kind, neko::strview msg, const neko::SrcLocInfo &srcLoc = {}) noexcept {
+            const auto seq = std::atomic_ref<neko::uint64>(header->nextSeq).fetch_add(1, std::memory_order_relaxed);
+            auto &slot = slots[seq % header->slotCount];
+            std::atomic_ref<neko::uint64> commit(slot.commit);
+
+            // Claim the slot, unless a writer one lap behind or ahead still owns it or already published a newer record
+            auto previous = commit.load(std::memory_order_relaxed);
+            do {
+                if (previous == detail::busy || (previous != 0 && previous > seq)) [[unlikely]] {
+                    std::atomic_ref<neko::uint64>(header->dropped).fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+            } while (!commit.compare_exchange_weak(previous, detail::busy, std::memory_order_relaxed));
+            std::atomic_thread_fence(std::memory_order_release);
+            slot.timestampNs = neko::wallClockNs();
+            slot.line = srcLoc.getLine();
+            slot.kind = static_cast<neko::uint8>(kind);
+            slot.flags = msg.size() > detail::Slot::messageCapacity ? detail::Slot::truncatedFlag : 0;
+            slot.fileLen = detail::copyTail(slot.file, detail::Slot::fileCapacity, srcLoc.getFile() ? srcLoc.getFile() : "");
+            slot.funcLen = detail::copyHead(slot.func, detail::Slot::funcCapacity, srcLoc.getFunc() ? srcLoc.getFunc() : "");
+            slot.messageLen = detail::copyHead(slot.message, detail::Slot::messageCapacity, msg);
+            commit.store(seq + 1, std::memory_order_release);
+        }
+
+        /**
+         * @brief Decode the records currently in the ring.
+         * @return Records ordered by seq, oldest first.
+         */
+        std::vector<Record> records() const {
+            return detail::decode(*header, slots);
+        }
+
+        /**
+         * @brief Total number of records appended over the file lifetime.
+         */
+        neko::uint64 appended() const noexcept {
+            return std::atomic_ref<neko::uint64>(header->nextSeq).load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Number of records dropped because their slot was still being written.
+         */
+        neko::uint64 dropped() const noexcept {
+            return std::atomic_ref<neko::uint64>(header->dropped).load(std::memory_order_relaxed);
+        }
+
+        std::size_t capacity() const noexcept {
+            return static_cast<std::size_t>(header->slotCount);
+        }
+
+        /**
+         * @brief Write the mapping to disk, only needed to survive a power loss (a crash is already safe).
+         */
+        void flush() noexcept {
+            mapping.flush();
+        }
+    };
+
+    /**
+     * @brief Decode a journal file, e.g. after the writing process crashed.
+     * @param path File path.
+     * @param srcLoc Source location information.
+     * @return Records ordered by seq, oldest first.
+     * @throws neko::ex::FileError if the file cannot be mapped.
+     * @throws neko::ex::ParseError if the file is not a journal, or its header does not match its size.
+     */
+    inline std::vector<Record> read(const std::string &path, const neko::SrcLocInfo &srcLoc = {}) {
+        const auto mapping = MappedFile::openRead(path, srcLoc);
+        if (mapping.size() < sizeof(detail::FileHeader)) {
+            neko::raise<neko::ex::ParseError>("Not an error journal: " + path, srcLoc);
+        }
+        const auto &header = *reinterpret_cast<const detail::FileHeader *>(mapping.data());
+        if (!detail::isValid(header)) {
+            neko::raise<neko::ex::ParseError>("Not an error journal: " + path, srcLoc);
+        }
+        if (!detail::fitsIn(header, mapping.size())) {
+            neko::raise<neko::ex::ParseError>("Truncated or corrupt error journal: " + path, srcLoc);
+        }
+        return detail::decode(header, reinterpret_cast<const detail::Slot *>(mapping.data() + sizeof(detail::FileHeader)));
+    }
+
+} // namespace neko::journal
@@ -0,0 +1,373 @@
+/**
+ * @file latency.hpp
+ * @brief Per call site latency histograms
+ * @details NEKO_SCOPED_TIMER registers a site lazily through neko::SrcLocInfo and records
+ * the scope duration into a log-bucketed (HDR style) histogram owned by the calling thread.
+ * snapshot() merges the thread shards and reports p50 / p99 / p999 per site.
+ */
+#pragma once
+
+#if !defined(NEKO_SCHEMA_ENABLE_MODULE) || (NEKO_SCHEMA_ENABLE_MODULE == false)
+#include <neko/schema/types.hpp>
+#include <neko/schema/srcLoc.hpp>
+#include <neko/schema/cycles.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+#endif // !NEKO_SCHEMA_ENABLE_MODULE
+
+/**
+ * @brief Latency metrics
+ * @namespace neko::metrics
+ */
+namespace neko::metrics {
+
+    /**
+     * @brief Log-bucketed histogram of nanosecond values.
+     * @details Each power of two is split into 16 linear sub-buckets, so any
+     * recorded value is reported with a relative error below 6.25%. Values below 16 are exact.
+     */
+    class Histogram {
+    public:
+        static constexpr unsigned subBucketBits = 4;
+        static constexpr std::size_t subBuckets = std::size_t{1} << subBucketBits;
+        static constexpr std::size_t bucketCount = (64 - subBucketBits + 1) * subBuckets;
+
+        /**
+         * @brief Index of the bucket holding value.
+         */
+        static constexpr std::size_t bucketOf(neko::uint64 value) noexcept {
+            if (value < subBuckets) {
+                return static_cast<std::size_t>(value);
+            }
+            const auto exp = static_cast<unsigned>(std::bit_width(value)) - subBucketBits;
+            return exp * subBuckets + static_cast<std::size_t>((value >> (exp - 1)) - subBuckets);
+        }
+
+        /**
+         * @brief Smallest value of a bucket.
+         */
+        static constexpr neko::uint64 lowerBound(std::size_t bucket) noexcept {
+            if (bucket < subBuckets) {
+                return bucket;
+            }
+            const auto exp = static_cast<unsigned>(bucket / subBuckets);
+            return static_cast<neko::uint64>(bucket % subBuckets + subBuckets) << (exp - 1);
+        }
+
+        /**
+         * @brief Largest value of a bucket.
+         */
+        static constexpr neko::uint64 upperBound(std::size_t bucket) noexcept {
+            if (bucket < subBuckets) {
+                return bucket;
+            }
+            const auto exp = static_cast<unsigned>(bucket / subBuckets);
+            return lowerBound(bucket) + ((neko::uint64{1} << (exp - 1)) - 1);
+        }
+
+        /**
+         * @brief Record a value.
+         * @param value Value in nanoseconds.
+         * @param times Number of samples of this value, 0 only updates the maximum.
+         */
+        void record(neko::uint64 value, neko::uint64 times = 1) noexcept {
+            counts[bucketOf(value)] += times;
+            total += times;
+            maxValue = std::max(maxValue, value);
+        }
+
+        void merge(const Histogram &other) noexcept {
+            for (std::size_t i = 0; i < bucketCount; ++i) {
+                counts[i] += other.counts[i];
+            }
+            total += other.total;
+            maxValue = std::max(maxValue, other.maxValue);
+        }
+
+        /**
+         * @brief Value at the given quantile.
+         * @param quantile In [0, 1], e.g. 0.99 for p99.
+         * @return Upper bound of the bucket holding the quantile (clamped to the maximum), 0 if empty.
+         */
+        neko::uint64 percentile(double quantile) const noexcept {
+            if (total == 0) {
+                return 0;
+            }
+            const auto clamped = std::clamp(quantile, 0.0, 1.0);
+            auto rank = static_cast<neko::uint64>(clamped * static_cast<double>(total));
+            if (static_cast<double>(rank) < clamped * static_cast<double>(total) || rank == 0) {
+                ++rank;
+            }
+            neko::uint64 seen = 0;
+            for (std::size_t i = 0; i < bucketCount; ++i) {
+                seen += counts[i];
+                if (seen >= rank) {
+                    return std::min(upperBound(i), maxValue);
+                }
+            }
+            return maxValue;
+        }
+
+        neko::uint64 count() const noexcept { return total; }
+        neko::uint64 max() const noexcept { return maxValue; }
+        neko::uint64 bucket(std::size_t index) const noexcept { return counts[index]; }
+
+    private:
+        std::array<neko::uint64, bucketCount> counts{};
+        neko::uint64 total = 0;
+        neko::uint64 maxValue = 0;
+    };
+
+    /**
+     * @brief Merged latency of one call site.
+     */
+    struct SiteLatency {
+        neko::SrcLocInfo site{nullptr, 0, nullptr};
+        neko::cstr name = nullptr;
+        neko::uint64 count = 0;
+        neko::uint64 p50 = 0;
+        neko::uint64 p99 = 0;
+        neko::uint64 p999 = 0;
+        neko::uint64 max = 0;
+        Histogram histogram;
+    };
+
+    namespace detail {
+
+        /**
+         * @brief Histogram of one site owned by one thread.
+         * @details Only the owning thread writes, so updates are plain relaxed load/store pairs
+         * (no read-modify-write); snapshot() reads them concurrently.
+         */
+        struct Shard {
+            std::array<std::atomic<neko::uint64>, Histogram::bucketCount> counts{};
+            std::atomic<neko::uint64> maxValue{0};
+
+            void record(neko::uint64 value) noexcept {
+                auto &bucket = counts[Histogram::bucketOf(value)];
+                bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                if (value > maxValue.load(std::memory_order_relaxed)) {
+                    maxValue.store(value, std::memory_order_relaxed);
+                }
+            }
+
+            void mergeInto(Histogram &histogram) const noexcept {
+                for (std::size_t i = 0; i < Histogram::bucketCount; ++i) {
+                    if (const auto n = counts[i].load(std::memory_order_relaxed)) {
+                        histogram.record(Histogram::lowerBound(i), n);
+                    }
+                }
+                histogram.record(maxValue.load(std::memory_order_relaxed), 0);
+            }
+        };
+
+        struct ThreadShards {
+            std::mutex mutex; // Guards growth of shards against snapshot()
+            std::vector<std::unique_ptr<Shard>> shards;
+
+            Shard &grow(std::size_t id) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (shards.size() <= id) {
+                    shards.resize(id + 1);
+                }
+                shards[id] = std::make_unique<Shard>();
+                return *shards[id];
+            }
+        };
+
+        struct SiteInfo {
+            neko::SrcLocInfo site;
+            neko::cstr name;
+        };
+
+        struct LatencyRegistry {
+            std::mutex mutex;
+            std::vector<SiteInfo> sites;
+            std::vector<std::shared_ptr<ThreadShards>> threads;
+            /// Samples of exited threads, indexed by site id
+            std::vector<Histogram> retired;
+        };
+
+        inline LatencyRegistry &latencyRegistry() {
+            // Intentionally leaked: timers may end during static destruction
+            static auto *registry = new LatencyRegistry();
+            return *registry;
+        }
+
+        /**
+         * @brief Fold the shards of exited threads into the retired histograms and drop them.
+         * @note Called with the registry mutex held.
+         */
+        inline void retireExited(LatencyRegistry &registry) {
+            std::erase_if(registry.threads, [&registry](const std::shared_ptr<ThreadShards> &thread) {
+                // Only referenced by the registry: the owning thread has exited
+                if (thread.use_count() != 1) {
+                    return false;
+                }
+                std::atomic_thread_fence(std::memory_order_acquire); // Pairs with the owner's release of its reference
+                if (registry.retired.size() < thread->shards.size()) {
+                    registry.retired.resize(thread->shards.size());
+                }
+                for (std::size_t id = 0; id < thread->shards.size(); ++id) {
+                    if (thread->shards[id]) {
+                        thread->shards[id]->mergeInto(registry.retired[id]);
+                    }
+                }
+                return true;
+            });
+        }
+
+        inline std::shared_ptr<ThreadShards> registerThread() {
+            auto shards = std::make_shared<ThreadShards>();
+            auto &registry = latencyRegistry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            // Bounds the registry under thread churn even if snapshot() is never called
+            retireExited(registry);
+            registry.threads.push_back(shards);
+            return shards;
+        }
+
+        /**
+         * @brief Shard of the calling thread for a site, allocated on first use.
+         * @return nullptr if it could not be allocated, the sample is then dropped.
+         */
+        inline Shard *localShard(std::size_t id) noexcept {
+            // The registry shares ownership until the thread exits, then its samples are retired
+            thread_local std::shared_ptr<ThreadShards> local;
+            if (local != nullptr && id < local->shards.size() && local->shards[id]) [[likely]] {
+                return local->shards[id].get();
+            }
+#if defined(__cpp_exceptions) || defined(_CPPUNWIND)
+            try {
+                if (local == nullptr) {
+                    local = registerThread();
+                }
+                return &local->grow(id);
+            } catch (...) {
+                return nullptr; // Recording runs in noexcept paths and destructors
+            }
+#else
+            if (local == nullptr) {
+                local = registerThread();
+            }
+            return &local->grow(id);
+#endif
+        }
+
+    } // namespace detail
+
+    /**
+     * @brief A registered call site, usually a function-local static created by NEKO_SCOPED_TIMER.
+     */
+    class TimerSite {
+    private:
+        std::size_t id;
+
+    public:
+        /**
+         * @brief Register a site.
+         * @param Name Optional static name, defaults to the function name of the call site.
+         * @param SrcLoc Source location information.
+         */
+        explicit TimerSite(neko::cstr Name = nullptr, const neko::SrcLocInfo &SrcLoc = {}) {
+            auto &registry = detail::latencyRegistry();
+            {
+                std::lock_guard<std::mutex> lock(registry.mutex);
+                id = registry.sites.size();
+                registry.sites.push_back(detail::SiteInfo{SrcLoc, Name});
+            }
+            // The constructing thread usually records into the site, allocate its shard now
+            (void)detail::localShard(id);
+        }
+
+        TimerSite(const TimerSite &) = delete;
+        TimerSite &operator=(const TimerSite &) = delete;
+
+        /**
+         * @brief Record a duration into the calling thread's shard.
+         * @param ns Duration in nanoseconds.
+         * @note The sample is dropped if the first sample of a thread cannot allocate its shard.
+         */
+        void record(neko::uint64 ns) noexcept {
+            if (auto *shard = detail::localShard(id)) [[likely]] {
+                shard->record(ns);
+            }
+        }
+
+        std::size_t getId() const noexcept { return id; }
+    };
+
+    /**
+     * @brief Records the lifetime of the scope into a TimerSite.
+     */
+    class ScopedTimer {
+    private:
+        TimerSite &site;
+        neko::uint64 begin;
+
+    public:
+        explicit ScopedTimer(TimerSite &Site) noexcept
+            : site(Site), begin(neko::monotonicNs()) {}
+
+        ScopedTimer(const ScopedTimer &) = delete;
+        ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+        ~ScopedTimer() {
+            site.record(neko::monotonicNs() - begin);
+        }
+    };
+
+    /**
+     * @brief Merge every thread's shards and summarize each site.
+     * @return One entry per registered site, in registration order.
+     */
+    inline std::vector<SiteLatency> snapshot() {
+        auto &registry = detail::latencyRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+
+        detail::retireExited(registry);
+        std::vector<SiteLatency> result(registry.sites.size());
+        for (std::size_t id = 0; id < registry.sites.size(); ++id) {
+            result[id].site = registry.sites[id].site;
+            result[id].name = registry.sites[id].name;
+            if (id < registry.retired.size()) {
+                result[id].histogram.merge(registry.retired[id]);
+            }
+        }
+        for (const auto &thread : registry.threads) {
+            std::lock_guard<std::mutex> shardLock(thread->mutex);
+            for (std::size_t id = 0; id < thread->shards.size() && id < result.size(); ++id) {
+                if (thread->shards[id]) {
+                    thread->shards[id]->mergeInto(result[id].histogram);
+                }
+            }
+        }
+        for (auto &entry : result) {
+            entry.count = entry.histogram.count();
+            entry.p50 = entry.histogram.percentile(0.50);
+            entry.p99 = entry.histogram.percentile(0.99);
+            entry.p999 = entry.histogram.percentile(0.999);
+            entry.max = entry.histogram.max();
+        }
+        return result;
+    }
+
+} // namespace neko::metrics
+
+#define NEKO_METRICS_CONCAT_IMPL(a, b) a##b
+#define NEKO_METRICS_CONCAT(a, b) NEKO_METRICS_CONCAT_IMPL(a, b)
+
+/**
+ * @brief Time the enclosing scope into the histogram of this call site.
+ * @details Optionally takes a static name: NEKO_SCOPED_TIMER("parse");
+ */
+#define NEKO_SCOPED_TIMER(...)                                                                                   \
+    static ::neko::metrics::TimerSite NEKO_METRICS_CONCAT(nekoTimerSite_, __LINE__){__VA_ARGS__};                \
+    const ::neko::metrics::ScopedTimer NEKO_METRICS_CONCAT(nekoScopedTimer_, __LINE__)(NEKO_METRICS_CONCAT(nekoTimerSite_, __LINE__))
@@ -0,0 +1,243 @@
+/**
+ * @file mappedFile.hpp
+ * @brief Minimal RAII memory-mapped file
+ * @details Read-only mappings for zero-copy readers, and shared read-write mappings
+ * whose content reaches the file even if the process crashes.
+ */
+#pragma once
+
+#if !defined(NEKO_SCHEMA_ENABLE_MODULE) || (NEKO_SCHEMA_ENABLE_MODULE == false)
+#include <neko/schema/types.hpp>
+#include <neko/schema/srcLoc.hpp>
+#include <neko/schema/exception.hpp>
+#include <neko/schema/raise.hpp>
+
+#include <cstddef>
+#include <cerrno>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#if defined(_WIN32)
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+#endif // !NEKO_SCHEMA_ENABLE_MODULE
+
+namespace neko {
+
+    /**
+     * @brief A file mapped into memory, unmapped on destruction.
+     */
+    class MappedFile {
+    private:
+        void *address = nullptr;
+        std::size_t length = 0;
+        bool writable = false;
+
+        MappedFile(void *Address, std::size_t Length, bool Writable) noexcept
+            : address(Address), length(Length), writable(Writable) {}
+
+        // Read before any cleanup call, which may overwrite it
+        static std::error_code lastError() noexcept {
+#if defined(_WIN32)
+            return std::error_code(static_cast<int>(::GetLastError()), std::system_category());
+#else
+            return std::error_code(errno, std::generic_category());
+#endif
+        }
+
+        [[noreturn]] static void fail(std::error_code code, neko::cstr what, const std::string &path, const neko::SrcLocInfo &srcLoc) {
+            neko::raise<neko::ex::FileError>(code, std::string(what) + ": " + path, srcLoc);
+        }
+
+    public:
+        MappedFile() noexcept = default;
+        MappedFile(MappedFile &&other) noexcept
+            : address(std::exchange(other.address, nullptr)), length(std::exchange(other.length, 0)), writable(other.writable) {}
+        MappedFile &operator=(MappedFile &&other) noexcept {
+            if (this != &other) {
+                unmap();
+                address = std::exchange(other.address, nullptr);
+                length = std::exchange(other.length, 0);
+                writable = other.writable;
+            }
+            return *this;
+        }
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        ~MappedFile() {
+            unmap();
+        }
+
+        /**
+         * @brief Map a whole file read-only.
+         * @param path File path.
+         * @param srcLoc Source location information.
+         * @throws neko::ex::FileError if the file cannot be opened or mapped.
+         */
+        static MappedFile openRead(const std::string &path, const neko::SrcLocInfo &srcLoc = {}) {
+#if defined(_WIN32)
+            HANDLE file = ::CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file == INVALID_HANDLE_VALUE) {
+                fail(lastError(), "Cannot open file", path, srcLoc);
+            }
+            LARGE_INTEGER size{};
+            if (!::GetFileSizeEx(file, &size)) {
+                const auto code = lastError();
+                ::CloseHandle(file);
+                fail(code, "Cannot stat file", path, srcLoc);
+            }
+            if (size.QuadPart == 0) {
+                ::CloseHandle(file);
+                return MappedFile();
+            }
+            HANDLE mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            const auto mappingError = lastError();
+            ::CloseHandle(file);
+            if (mapping == nullptr) {
+                fail(mappingError, "Cannot map file", path, srcLoc);
+            }
+            void *view = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            const auto viewError = lastError();
+            ::CloseHandle(mapping);
+            if (view == nullptr) {
+                fail(viewError, "Cannot map file", path, srcLoc);
+            }
+            return MappedFile(view, static_cast<std::size_t>(size.QuadPart), false);
+#else
+            const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) {
+                fail(lastError(), "Cannot open file", path, srcLoc);
+            }
+            struct stat info{};
+            if (::fstat(fd, &info) != 0) {
+                const auto code = lastError();
+                ::close(fd);
+                fail(code, "Cannot stat file", path, srcLoc);
+            }
+            if (info.st_size == 0) {
+                ::close(fd);
+                return MappedFile();
+            }
+            void *view = ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            const auto mapError = lastError();
+            ::close(fd);
+            if (view == MAP_FAILED) {
+                fail(mapError, "Cannot map file", path, srcLoc);
+            }
+            return MappedFile(view, static_cast<std::size_t>(info.st_size), false);
+#endif
+        }
+
+        /**
+         * @brief Map a file read-write and shared, creating it or growing it to size bytes.
+         * @details Stores into the mapping reach the file through the page cache, even if the process crashes.
+         * @param path File path.
+         * @param size Size of the mapping, must be greater than 0.
+         * @param srcLoc Source location information.
+         * @throws neko::ex::FileError if the file cannot be created or mapped.
+         */
+        static MappedFile openWrite(const std::string &path, std::size_t size, const neko::SrcLocInfo &srcLoc = {}) {
+#if defined(_WIN32)
+            HANDLE file = ::CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file == INVALID_HANDLE_VALUE) {
+                fail(lastError(), "Cannot open file", path, srcLoc);
+            }
+            // Mapping with an explicit size grows the file when needed
+            const auto wide = static_cast<neko::uint64>(size);
+            HANDLE mapping = ::CreateFileMappingA(file, nullptr, PAGE_READWRITE, static_cast<DWORD>(wide >> 32), static_cast<DWORD>(wide & 0xFFFFFFFFu), nullptr);
+            const auto mappingError = lastError();
+            ::CloseHandle(file);
+            if (mapping == nullptr) {
+                fail(mappingError, "Cannot map file", path, srcLoc);
+            }
+            void *view = ::MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+            const auto viewError = lastError();
+            ::CloseHandle(mapping);
+            if (view == nullptr) {
+                fail(viewError, "Cannot map file", path, srcLoc);
+            }
+            return MappedFile(view, size, true);
+#else
+            const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+            if (fd < 0) {
+                fail(lastError(), "Cannot open file", path, srcLoc);
+            }
+            struct stat info{};
+            if (::fstat(fd, &info) != 0) {
+                const auto code = lastError();
+                ::close(fd);
+                fail(code, "Cannot stat file", path, srcLoc);
+            }
+            if (static_cast<std::size_t>(info.st_size) < size && ::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+                const auto code = lastError();
+                ::close(fd);
+                fail(code, "Cannot resize file", path, srcLoc);
+            }
+            void *view = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            const auto mapError = lastError();
+            ::close(fd);
+            if (view == MAP_FAILED) {
+                fail(mapError, "Cannot map file", path, srcLoc);
+            }
+            return MappedFile(view, size, true);
+#endif
+        }
+
+        /**
+         * @brief Unmap the file, does nothing if not mapped.
+         */
+        void unmap() noexcept {
+            if (address == nullptr) {
+                return;
+            }
+#if defined(_WIN32)
+            ::UnmapViewOfFile(address);
+#else
+            ::munmap(address, length);
+#endif
+            address = nullptr;
+            length = 0;
+        }
+
+        /**
+         * @brief Flush a writable mapping to disk (not needed for crash safety, only for power loss).
+         */
+        void flush() noexcept {
+            if (address == nullptr || !writable) {
+                return;
+            }
+#if defined(_WIN32)
+            ::FlushViewOfFile(address, length);
+#else
+            ::msync(address, length, MS_SYNC);
+#endif
+        }
+
+        std::byte *data() noexcept { return static_cast<std::byte *>(address); }
+        const std::byte *data() const noexcept { return static_cast<const std::byte *>(address); }
+        std::size_t size() const noexcept { return length; }
+        bool isWritable() const noexcept { return writable; }
+        bool isMapped() const noexcept { return address != nullptr; }
+
+        /**
+         * @brief View of the mapped bytes as text.
+         */
+        neko::strview view() const noexcept {
+            return address ? neko::strview(static_cast<neko::cstr>(address), length) : neko::strview();
+        }
+    };
+
+} // namespace neko
@@ -0,0 +1,35 @@
+// =====================
+// === Global Module ===
+// =====================
+
+module;
+
+// ====================
+// = Standard Library =
+// ====================
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <utility>
+
+// =====================
+// = Module Partition ==
+// =====================
+
+export module neko.schema:admission;
+
+import :types;
+import :srcloc;
+import :cycles;
+import :exception;
+import :raise;
+
+// Control header files to not import dependencies (dependencies are declared and imported by the cppm)
+#define NEKO_SCHEMA_ENABLE_MODULE true
+
+export {
+#include "admission.hpp"
+}
@@ -0,0 +1,38 @@
+// =====================
+// === Global Module ===
+// =====================
+
+module;
+
+// ====================
+// = Standard Library =
+// ====================
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+// =====================
+// = Module Partition ==
+// =====================
+
+export module neko.schema:config;
+
+import :types;
+import :srcloc;
+import :exception;
+import :raise;
+
+// Control header files to not import dependencies (dependencies are declared and imported by the cppm)
+#define NEKO_SCHEMA_ENABLE_MODULE true
+
+export {
+#include "config.hpp"
+}
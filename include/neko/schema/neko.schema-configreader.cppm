@@ -0,0 +1,35 @@
+// =====================
+// === Global Module ===
+// =====================
+
+module;
+
+// ====================
+// = Standard Library =
+// ====================
+
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <string>
+#include <vector>
+
+// =====================
+// = Module Partition ==
+// =====================
+
+export module neko.schema:configreader;
+
+import :types;
+import :srcloc;
+import :exception;
+import :raise;
+import :mappedfile;
+import :config;
+
+// Control header files to not import dependencies (dependencies are declared and imported by the cppm)
+#define NEKO_SCHEMA_ENABLE_MODULE true
+
+export {
+#include "configReader.hpp"
+}
@@ -0,0 +1,32 @@
+// =====================
+// === Global Module ===
+// =====================
+
+module;
+
+// ====================
+// = Standard Library =
+// ====================
+
+#include <chrono>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// =====================
+// = Module Partition ==
+// =====================
+
+export module neko.schema:cycles;
+
+import :types;
+
+// Control header files to not import dependencies (dependencies are declared and imported by the cppm)
+#define NEKO_SCHEMA_ENABLE_MODULE true
+
+export {
+#include "cycles.hpp"
+}
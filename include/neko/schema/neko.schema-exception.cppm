@@ -0,0 +1,36 @@
+// =====================
+// === Global Module ===
+// =====================
+
+module;
+
+// ====================
+// = Standard Library =
+// ====================
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <new>
+#include <string>
+#include <system_error>
+#include <utility>
+
+// =====================
+// = Module Partition ==
+// =====================
+
+export module neko.schema:exception;
+
+import :types;
+import :srcloc;
+import :cycles;
+
+// Control header files to not import dependencies (dependencies are declared and imported by the cppm)
+#define NEKO_SCHEMA_ENABLE_MODULE true
+
+export {
+#include "exception.hpp"
+}
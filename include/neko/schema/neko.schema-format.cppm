@@ -0,0 +1,34 @@
+// =====================
+// === Global Module ===
+// =====================
+
+module;
+
+// ====================
+// = Standard Library =
+// ====================
+
+#include <version>
+#if defined(__cpp_lib_format)
+#include <concepts>
+#include <exception>
+#include <format>
+#include <string_view>
+#endif
+
+// =====================
+// = Module Partition ==
+// =====================
+
+export module neko.schema:format;
+
+import :types;
+import :srcloc;
+import :exception;
+import :raise;
+
+// Control header files to not import dependencies (dependencies are declared and imported by the cppm)
+#define NEKO_SCHEMA_ENABLE_MODULE true
+
+// Not wrapped in export: std::formatter specializations are reachable by every importer
+#include "format.hpp"
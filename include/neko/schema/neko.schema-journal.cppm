@@ -0,0 +1,39 @@
+// =====================
+// === Global Module ===
+// =====================
+
+module;
+
+// ====================
+// = Standard Library =
+// ====================
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <system_error>
+#include <vector>
+
+// =====================
+// = Module Partition ==
+// =====================
+
+export module neko.schema:journal;
+
+import :types;
+import :srcloc;
+import :cycles;
+import :exception;
+import :raise;
+import :throwhook;
+import :mappedfile;
+
+// Control header files to not import dependencies (dependencies are declared and imported by the cppm)
+#define NEKO_SCHEMA_ENABLE_MODULE true
+
+export {
+#include "journal.hpp"
+}
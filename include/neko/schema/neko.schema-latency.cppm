@@ -0,0 +1,37 @@
+// =====================
+// === Global Module ===
+// =====================
+
+module;
+
+// ====================
+// = Standard Library =
+// ====================
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// =====================
+// = Module Partition ==
+// =====================
+
+export module neko.schema:latency;
+
+import :types;
+import :srcloc;
+import :cycles;
+
+// Control header files to not import dependencies (dependencies are declared and imported by the cppm)
+#define NEKO_SCHEMA_ENABLE_MODULE true
+
+// NEKO_SCOPED_TIMER is a macro and is not exported, module users construct
+// neko::metrics::TimerSite and neko::metrics::ScopedTimer directly.
+export {
+#include "latency.hpp"
+}
@@ -0,0 +1,33 @@
+// =====================
+// === Global Module ===
+// =====================
+
+module;
+
+// ====================
+// = Standard Library =
+// ====================
+
+#include <atomic>
+#include <concepts>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <system_error>
+
+// =====================
+// = Module Partition ==
+// =====================
+
+export module neko.schema:raise;
+
+import :types;
+import :srcloc;
+import :exception;
+
+// Control header files to not import dependencies (dependencies are declared and imported by the cppm)
+#define NEKO_SCHEMA_ENABLE_MODULE true
+
+export {
+#include "raise.hpp"
+}
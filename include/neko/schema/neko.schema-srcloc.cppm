@@ -0,0 +1,27 @@
+// =====================
+// === Global Module ===
+// =====================
+
+module;
+
+// ====================
+// = Standard Library =
+// ====================
+
+#include <source_location>
+#include <version>
+
+// =====================
+// = Module Partition ==
+// =====================
+
+export module neko.schema:srcloc;
+
+import :types;
+
+// Control header files to not import dependencies (dependencies are declared and imported by the cppm)
+#define NEKO_SCHEMA_ENABLE_MODULE true
+
+export {
+#include "srcLoc.hpp"
+}
@@ -0,0 +1,33 @@
+// =====================
+// === Global Module ===
+// =====================
+
+module;
+
+// ====================
+// = Standard Library =
+// ====================
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <vector>
+
+// =====================
+// = Module Partition ==
+// =====================
+
+export module neko.schema:statevector;
+
+import :types;
+import :srcloc;
+import :exception;
+import :raise;
+
+// Control header files to not import dependencies (dependencies are declared and imported by the cppm)
+#define NEKO_SCHEMA_ENABLE_MODULE true
+
+export {
+#include "stateVector.hpp"
+}
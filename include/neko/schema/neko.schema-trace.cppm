@@ -0,0 +1,35 @@
+// =====================
+// === Global Module ===
+// =====================
+
+module;
+
+// ====================
+// = Standard Library =
+// ====================
+
+#include <atomic>
+#include <charconv>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <span>
+#include <vector>
+
+// =====================
+// = Module Partition ==
+// =====================
+
+export module neko.schema:trace;
+
+import :types;
+import :srcloc;
+import :cycles;
+
+// Control header files to not import dependencies (dependencies are declared and imported by the cppm)
+#define NEKO_SCHEMA_ENABLE_MODULE true
+
+export {
+#include "trace.hpp"
+}
@@ -0,0 +1,25 @@
+// =====================
+// === Global Module ===
+// =====================
+
+module;
+
+// ====================
+// = Standard Library =
+// ====================
+
+#include <cstdint>
+#include <string_view>
+
+// =====================
+// = Module Partition ==
+// =====================
+
+export module neko.schema:types;
+
+// Control header files to not import dependencies (dependencies are declared and imported by the cppm)
+#define NEKO_SCHEMA_ENABLE_MODULE true
+
+export {
+#include "types.hpp"
+}
@@ -1,31 +1,25 @@
-// =====================
-// === Global Module ===
-// =====================
-
-module;
-
-// ====================
-// = Standard Library =
-// ====================
-
-#include <cstdint>
-#include <exception>
-#include <source_location>
-#include <string>
-#include <string_view>
-
 // =====================
 // = Module Interface ==
 // =====================
 
 export module neko.schema;
 
-// Control header files to not import dependencies (dependencies are declared and imported by the cppm)
-#define NEKO_SCHEMA_ENABLE_MODULE true
-
-// Export all declarations from the headers by including them in an export block
-export {
-#include "types.hpp"
-#include "srcLoc.hpp"
-#include "exception.hpp"
-}
+// The module is split into partitions so each part is compiled on its own
+// and rebuilt only when the headers behind it change.
+export import :types;
+export import :srcloc;
+export import :cycles;
+export import :exception;
+export import :parse;
+export import :raise;
+export import :throwhook;
+export import :trace;
+export import :latency;
+export import :admission;
+export import :statevector;
+export import :mappedfile;
+export import :journal;
+export import :format;
+export import :config;
+export import :configreader;
+export import :throwsites;
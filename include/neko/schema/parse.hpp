@@ -0,0 +1,227 @@
+/**
+ * @file parse.hpp
+ * @brief Numeric parsing primitives over neko::strview
+ * @details Failures raise neko::ex::ParseError carrying the byte offset, line and column of the failure.
+ */
+#pragma once
+
+#if !defined(NEKO_SCHEMA_ENABLE_MODULE) || (NEKO_SCHEMA_ENABLE_MODULE == false)
+#include <neko/schema/types.hpp>
+#include <neko/schema/srcLoc.hpp>
+#include <neko/schema/exception.hpp>
+#include <neko/schema/raise.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <system_error>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#endif
+#endif // !NEKO_SCHEMA_ENABLE_MODULE
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define NEKO_SCHEMA_PARSE_SSE2 1
+#endif
+
+/**
+ * @brief Parsing primitives
+ * @namespace neko::parse
+ */
+namespace neko::parse {
+
+    /**
+     * @brief Integer types accepted by the parsing functions (bool is excluded).
+     */
+    template <typename T>
+    concept Integer = std::integral<T> && !std::same_as<T, bool>;
+
+    /**
+     * @brief Compute the line and column of a byte offset in the text.
+     * @param text The whole input.
+     * @param offset Byte offset inside the input, clamped to its size.
+     * @return Position with 1-based line and column.
+     */
+    constexpr neko::TextPos locate(neko::strview text, std::size_t offset) noexcept {
+        offset = std::min(offset, text.size());
+        const neko::strview head = text.substr(0, offset);
+        const auto lineStart = head.rfind('\n');
+        const auto column = (lineStart == neko::strview::npos) ? offset : offset - lineStart - 1;
+        const auto lines = std::count(head.begin(), head.end(), '\n');
+        return {offset, static_cast<neko::uint32>(lines + 1), static_cast<neko::uint32>(column + 1)};
+    }
+
+    /**
+     * @brief Length of the run of ASCII digits starting at first.
+     * @details Scans 16 bytes per step with SSE2 when available.
+     */
+    inline std::size_t digitRun(const char *first, const char *last) noexcept {
+        const char *p = first;
+#if defined(NEKO_SCHEMA_PARSE_SSE2)
+        const __m128i zero = _mm_set1_epi8('0');
+        const __m128i nine = _mm_set1_epi8(9);
+        while (last - p >= 16) {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+            const __m128i value = _mm_sub_epi8(chunk, zero);
+            // value <= 9 as unsigned bytes <=> the byte is a digit
+            const __m128i isDigit = _mm_cmpeq_epi8(_mm_min_epu8(value, nine), value);
+            const auto stop = static_cast<unsigned>(~_mm_movemask_epi8(isDigit)) & 0xFFFFu;
+            if (stop != 0) {
+                return static_cast<std::size_t>(p - first) + static_cast<std::size_t>(std::countr_zero(stop));
+            }
+            p += 16;
+        }
+#endif
+        while (p != last && static_cast<unsigned char>(*p - '0') <= 9) {
+            ++p;
+        }
+        return static_cast<std::size_t>(p - first);
+    }
+
+    namespace detail {
+
+        [[noreturn]] inline void raiseAt(neko::strview text, std::size_t offset, neko::cstr msg, const neko::SrcLocInfo &srcLoc) {
+            neko::raise<neko::ex::ParseError>(locate(text, offset), msg, srcLoc);
+        }
+
+        /**
+         * @brief Parse one field [first, last) of text, raising on any failure.
+         */
+        template <Integer T>
+        T parseField(neko::strview text, std::size_t first, std::size_t last, const neko::SrcLocInfo &srcLoc) {
+            const char *begin = text.data() + first;
+            const char *end = text.data() + last;
+            if (begin == end) {
+                raiseAt(text, first, "Empty number", srcLoc);
+            }
+
+            const char *digits = begin;
+            if constexpr (std::signed_integral<T>) {
+                if (*digits == '-') {
+                    ++digits;
+                }
+            }
+            const std::size_t run = digitRun(digits, end);
+            if (run == 0) {
+                raiseAt(text, static_cast<std::size_t>(digits - text.data()), "Expected digit", srcLoc);
+            }
+            if (digits + run != end) {
+                raiseAt(text, static_cast<std::size_t>(digits + run - text.data()), "Invalid character in number", srcLoc);
+            }
+
+            T value{};
+            const auto [ptr, ec] = std::from_chars(begin, end, value);
+            if (ec == std::errc::result_out_of_range) {
+                raiseAt(text, first, "Number out of range", srcLoc);
+            }
+            if (ec != std::errc{} || ptr != end) {
+                raiseAt(text, static_cast<std::size_t>(ptr - text.data()), "Invalid number", srcLoc);
+            }
+            return value;
+        }
+
+    } // namespace detail
+
+    /**
+     * @brief Parse the whole text as an integer without throwing.
+     * @param text Input, must contain only the number.
+     * @param out Receives the value on success, untouched otherwise.
+     * @return True on success.
+     */
+    template <Integer T>
+    [[nodiscard]] bool tryToNumber(neko::strview text, T &out) noexcept {
+        T value{};
+        const auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (ec != std::errc{} || ptr != text.data() + text.size()) {
+            return false;
+        }
+        out = value;
+        return true;
+    }
+
+    /**
+     * @brief Parse the whole text as an integer.
+     * @param text Input, must contain only the number.
+     * @param srcLoc Source location information.
+     * @return The parsed value.
+     * @throws neko::ex::ParseError with the position of the failure.
+     */
+    template <Integer T>
+    T toNumber(neko::strview text, const neko::SrcLocInfo &srcLoc = {}) {
+        T value{};
+        if (tryToNumber(text, value)) {
+            return value;
+        }
+        return detail::parseField<T>(text, 0, text.size(), srcLoc);
+    }
+
+    /**
+     * @brief Parse a delimited list of integers, e.g. "1,2,3\n4,5,6".
+     *
+     * Fields are separated by delim or by a line break ("\n" or "\r\n"),
+     * a trailing line break is allowed but a trailing delimiter is not (it leaves an empty field).
+     * Digit runs are scanned with SIMD when available.
+     *
+     * @param text Input.
+     * @param delim Field delimiter.
+     * @param out Parsed values are appended to it, on failure it is restored to its original size.
+     * @param srcLoc Source location information.
+     * @return Number of values appended.
+     * @throws neko::ex::ParseError with the position of the first failure.
+     */
+    template <Integer T>
+    std::size_t toNumbers(neko::strview text, char delim, std::vector<T> &out, const neko::SrcLocInfo &srcLoc = {}) {
+        const std::size_t before = out.size();
+        const char *const data = text.data();
+        const std::size_t size = text.size();
+
+        const auto fail = [&](std::size_t offset, neko::cstr msg) {
+            out.erase(out.begin() + static_cast<std::ptrdiff_t>(before), out.end());
+            detail::raiseAt(text, offset, msg, srcLoc);
+        };
+
+        std::size_t pos = 0;
+        while (pos < size) {
+            const std::size_t first = pos;
+            std::size_t digits = first;
+            if constexpr (std::signed_integral<T>) {
+                if (data[digits] == '-') {
+                    ++digits;
+                }
+            }
+            const std::size_t last = digits + digitRun(data + digits, data + size);
+            if (last == digits) {
+                fail(digits, "Expected digit");
+            }
+
+            // Field terminator: delimiter, line break or end of input
+            std::size_t next = last;
+            if (last < size) {
+                const char c = data[last];
+                if (c == delim && c != '\n' && last + 1 == size) {
+                    fail(size, "Expected digit"); // Empty last field
+                } else if (c == delim || c == '\n') {
+                    next = last + 1;
+                } else if (c == '\r' && last + 1 < size && data[last + 1] == '\n') {
+                    next = last + 2;
+                } else {
+                    fail(last, "Invalid character in number");
+                }
+            }
+
+            T value{};
+            const auto [ptr, ec] = std::from_chars(data + first, data + last, value);
+            if (ec != std::errc{}) {
+                fail(first, "Number out of range");
+            }
+            out.push_back(value);
+            pos = next;
+        }
+        return out.size() - before;
+    }
+
+} // namespace neko::parse
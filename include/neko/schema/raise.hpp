@@ -0,0 +1,169 @@
+/**
+ * @file raise.hpp
+ * @brief Uniform error reporting for builds with and without exceptions
+ * @details In normal builds neko::raise throws the matching neko::ex class.
+ * When NEKO_SCHEMA_NO_EXCEPTIONS is defined (automatically under -fno-exceptions),
+ * it builds an ErrorRecord and calls the installed failure handler instead.
+ * @note All translation units of a program must agree on NEKO_SCHEMA_NO_EXCEPTIONS.
+ */
+#pragma once
+
+#if !defined(NEKO_SCHEMA_ENABLE_MODULE) || (NEKO_SCHEMA_ENABLE_MODULE == false)
+#include <neko/schema/types.hpp>
+#include <neko/schema/srcLoc.hpp>
+#include <neko/schema/exception.hpp>
+
+#include <atomic>
+#include <concepts>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <system_error>
+#endif // !NEKO_SCHEMA_ENABLE_MODULE
+
+#if !defined(NEKO_SCHEMA_NO_EXCEPTIONS) && !defined(__cpp_exceptions) && !defined(_CPPUNWIND)
+    #define NEKO_SCHEMA_NO_EXCEPTIONS
+#endif
+
+// Keeps the raising code out of line and in the cold text section, so callers only pay for a call
+#if !defined(NEKO_SCHEMA_COLD)
+    #if defined(__GNUC__) || defined(__clang__)
+        #define NEKO_SCHEMA_COLD __attribute__((cold, noinline))
+    #elif defined(_MSC_VER)
+        #define NEKO_SCHEMA_COLD __declspec(noinline)
+    #else
+        #define NEKO_SCHEMA_COLD
+    #endif
+#endif
+
+namespace neko {
+
+    /**
+     * @brief Description of a raised error, passed to the failure handler.
+     */
+    struct ErrorRecord {
+        neko::ex::ErrorKind kind = neko::ex::ErrorKind::Exception;
+        neko::strview message;
+        neko::SrcLocInfo srcLoc{nullptr, 0, nullptr};
+        /// Set for errors raised with an error code (neko::ex::SystemError and subclasses)
+        std::error_code code{};
+        /// Set for parse errors raised at a position of the input
+        neko::TextPos pos{};
+    };
+
+    /**
+     * @brief Failure handler used when exceptions are disabled.
+     * @note The handler must not return (e.g. log and std::abort / std::quick_exit);
+     * if it does, the default handler runs afterwards and aborts.
+     */
+    using FailureHandler = void (*)(const ErrorRecord &record);
+
+    namespace detail {
+
+        inline std::atomic<FailureHandler> failureHandler{nullptr};
+
+        [[noreturn]] inline void defaultFailureHandler(const ErrorRecord &record) noexcept {
+            std::fprintf(stderr, "%s: %.*s (%s:%u in %s)\n",
+                         neko::ex::toString(record.kind),
+                         static_cast<int>(record.message.size()), record.message.data(),
+                         record.srcLoc.getFile() ? record.srcLoc.getFile() : "unknown",
+                         static_cast<unsigned>(record.srcLoc.getLine()),
+                         record.srcLoc.getFunc() ? record.srcLoc.getFunc() : "unknown");
+            if (record.pos.hasInfo()) {
+                std::fprintf(stderr, "  at offset %llu (line %u, column %u)\n",
+                             static_cast<unsigned long long>(record.pos.getOffset()),
+                             static_cast<unsigned>(record.pos.getLine()), static_cast<unsigned>(record.pos.getColumn()));
+            }
+            if (record.code) {
+                std::fprintf(stderr, "  error code %d: %s\n", record.code.value(), record.code.message().c_str());
+            }
+            std::abort();
+        }
+
+        [[noreturn]] inline void fail(const ErrorRecord &record) noexcept {
+            // Throw hooks observe the error as if the exception had been constructed
+            if (neko::ex::detail::throwHooks.load(std::memory_order_relaxed) != nullptr) [[unlikely]] {
+                (void)neko::ex::detail::notifyThrowHooks(record.kind, record.message, record.srcLoc);
+            }
+            if (const FailureHandler handler = failureHandler.load(std::memory_order_acquire)) {
+                handler(record);
+            }
+            defaultFailureHandler(record);
+        }
+
+    } // namespace detail
+
+    /**
+     * @brief Install the failure handler used when exceptions are disabled.
+     * @param handler The new handler, nullptr restores the default (print and abort).
+     * @return The previous handler.
+     */
+    inline FailureHandler setFailureHandler(FailureHandler handler) noexcept {
+        return detail::failureHandler.exchange(handler, std::memory_order_acq_rel);
+    }
+
+    /**
+     * @brief Get the installed failure handler.
+     * @return The handler, nullptr if the default is used.
+     */
+    inline FailureHandler getFailureHandler() noexcept {
+        return detail::failureHandler.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Raise an error of the given class.
+     *
+     * Throws ErrorType when exceptions are enabled, otherwise reports an ErrorRecord
+     * of ErrorType::kind to the failure handler.
+     * Never inlined and placed in the cold section: prefer it over a throw expression
+     * on hot paths, the caller only passes a pointer/size pair and the source location.
+     *
+     * @tparam ErrorType A class from neko::ex.
+     * @param msg Error message.
+     * @param srcLoc Source location information.
+     */
+    template <typename ErrorType>
+        requires std::derived_from<ErrorType, neko::ex::Exception>
+    [[noreturn]] NEKO_SCHEMA_COLD void raise(neko::strview msg, const neko::SrcLocInfo &srcLoc = {}) {
+#if defined(NEKO_SCHEMA_NO_EXCEPTIONS)
+        detail::fail(ErrorRecord{ErrorType::kind, msg, srcLoc});
+#else
+        throw ErrorType(std::string(msg), srcLoc);
+#endif
+    }
+
+    /**
+     * @brief Raise an error carrying an error code.
+     * @tparam ErrorType neko::ex::SystemError or a subclass.
+     * @param code Error code, e.g. std::error_code(errno, std::generic_category()).
+     * @param msg Optional context, the code message is appended lazily by what().
+     * @param srcLoc Source location information.
+     */
+    template <typename ErrorType>
+        requires std::derived_from<ErrorType, neko::ex::SystemError>
+    [[noreturn]] NEKO_SCHEMA_COLD void raise(std::error_code code, neko::strview msg = {}, const neko::SrcLocInfo &srcLoc = {}) {
+#if defined(NEKO_SCHEMA_NO_EXCEPTIONS)
+        detail::fail(ErrorRecord{ErrorType::kind, msg, srcLoc, code});
+#else
+        throw ErrorType(code, std::string(msg), srcLoc);
+#endif
+    }
+
+    /**
+     * @brief Raise a parse error at a position of the input.
+     * @tparam ErrorType neko::ex::ParseError or a subclass.
+     * @param pos Position of the failure.
+     * @param msg Error message.
+     * @param srcLoc Source location information.
+     */
+    template <typename ErrorType>
+        requires std::derived_from<ErrorType, neko::ex::ParseError>
+    [[noreturn]] NEKO_SCHEMA_COLD void raise(const neko::TextPos &pos, neko::strview msg, const neko::SrcLocInfo &srcLoc = {}) {
+#if defined(NEKO_SCHEMA_NO_EXCEPTIONS)
+        detail::fail(ErrorRecord{ErrorType::kind, msg, srcLoc, {}, pos});
+#else
+        throw ErrorType(pos, std::string(msg), srcLoc);
+#endif
+    }
+
+} // namespace neko
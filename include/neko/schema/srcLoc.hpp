@@ -44,4 +44,21 @@ namespace neko {
         }
     };
 
+    /**
+     * @brief Position inside a parsed text input
+     * @note line and column are 1-based, a line of 0 means the position is unknown.
+     */
+    struct TextPos {
+        neko::uint64 offset = 0;
+        neko::uint32 line = 0;
+        neko::uint32 column = 0;
+
+        constexpr neko::uint64 getOffset() const noexcept { return offset; }
+        constexpr neko::uint32 getLine() const noexcept { return line; }
+        constexpr neko::uint32 getColumn() const noexcept { return column; }
+        constexpr bool hasInfo() const noexcept {
+            return line != 0;
+        }
+    };
+
 } // namespace neko
\ No newline at end of file
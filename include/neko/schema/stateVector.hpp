@@ -0,0 +1,258 @@
+/**
+ * @file stateVector.hpp
+ * @brief Bit-packed container of neko::State
+ * @details Stores each State in 2 bits (32 per 64-bit word) with atomic per-item updates,
+ * and word-parallel kernels to count states, find the next RetryRequired/Failed item and
+ * merge the results of parallel workers.
+ */
+#pragma once
+
+#if !defined(NEKO_SCHEMA_ENABLE_MODULE) || (NEKO_SCHEMA_ENABLE_MODULE == false)
+#include <neko/schema/types.hpp>
+#include <neko/schema/srcLoc.hpp>
+#include <neko/schema/exception.hpp>
+#include <neko/schema/raise.hpp>
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <vector>
+#endif // !NEKO_SCHEMA_ENABLE_MODULE
+
+namespace neko {
+
+    /**
+     * @brief Vector of neko::State packed at 2 bits per item.
+     *
+     * get / set / exchange / compareExchange are atomic per item and may be used concurrently.
+     * The bulk kernels (count, findNext, merge) read words with plain loads for speed and
+     * should run once the writers are done, e.g. after the workers of a batch joined.
+     */
+    class StateVector {
+    public:
+        static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+        static constexpr std::size_t statesPerWord = 32;
+
+    private:
+        static constexpr neko::uint64 lowBits = 0x5555555555555555ull;
+        static constexpr neko::uint64 highBits = 0xAAAAAAAAAAAAAAAAull;
+
+        std::vector<neko::uint64> words;
+        std::size_t itemCount = 0;
+
+        static constexpr neko::uint64 pattern(State state) noexcept {
+            return static_cast<neko::uint64>(state) * lowBits;
+        }
+
+        static constexpr unsigned shiftOf(std::size_t index) noexcept {
+            return static_cast<unsigned>(index % statesPerWord) * 2;
+        }
+
+        // One bit (at the low bit of each lane) for every lane equal to state
+        static constexpr neko::uint64 lanesEqual(neko::uint64 word, State state) noexcept {
+            const auto diff = word ^ pattern(state);
+            return ~(diff | (diff >> 1)) & lowBits;
+        }
+
+        // Mask of the lanes of word that hold items, i.e. excluding the padding of the last word
+        neko::uint64 validMask(std::size_t wordIndex) const noexcept {
+            const auto used = itemCount - wordIndex * statesPerWord;
+            return used >= statesPerWord ? ~neko::uint64{0} : (neko::uint64{1} << (used * 2)) - 1;
+        }
+
+        std::atomic_ref<neko::uint64> wordRef(std::size_t index) noexcept {
+            return std::atomic_ref<neko::uint64>(words[index / statesPerWord]);
+        }
+
+        neko::uint64 loadWord(std::size_t index) const noexcept {
+            // atomic_ref requires a non-const object, the load does not modify it
+            return std::atomic_ref<neko::uint64>(const_cast<neko::uint64 &>(words[index / statesPerWord])).load(std::memory_order_relaxed);
+        }
+
+        template <typename Scan>
+        std::size_t findFirst(std::size_t from, Scan scan) const noexcept {
+            if (from >= itemCount) {
+                return npos;
+            }
+            std::size_t w = from / statesPerWord;
+            // Skip the lanes before from in the first word
+            neko::uint64 bits = scan(words[w]) & validMask(w) & (~neko::uint64{0} << shiftOf(from));
+            while (true) {
+                if (bits != 0) {
+                    return w * statesPerWord + static_cast<std::size_t>(std::countr_zero(bits)) / 2;
+                }
+                if (++w == words.size()) {
+                    return npos;
+                }
+                bits = scan(words[w]) & validMask(w);
+            }
+        }
+
+    public:
+        StateVector() = default;
+
+        /**
+         * @brief Construct a vector of size items set to initial.
+         */
+        explicit StateVector(std::size_t size, State initial = State::Completed) {
+            resize(size, initial);
+        }
+
+        /**
+         * @brief Resize the vector, new items are set to initial.
+         * @note Not safe to call concurrently with any other member.
+         */
+        void resize(std::size_t size, State initial = State::Completed) {
+            const auto oldCount = itemCount;
+            words.resize((size + statesPerWord - 1) / statesPerWord, 0);
+            itemCount = size;
+            if (size < oldCount && !words.empty()) {
+                words.back() &= validMask(words.size() - 1);
+            }
+            for (std::size_t i = oldCount; i < size; ++i) {
+                if (i % statesPerWord == 0 && size - i >= statesPerWord) {
+                    words[i / statesPerWord] = pattern(initial);
+                    i += statesPerWord - 1;
+                    continue;
+                }
+                auto &word = words[i / statesPerWord];
+                word = (word & ~(neko::uint64{3} << shiftOf(i))) | (static_cast<neko::uint64>(initial) << shiftOf(i));
+            }
+        }
+
+        std::size_t size() const noexcept { return itemCount; }
+        bool empty() const noexcept { return itemCount == 0; }
+        /// Bytes used by the packed storage
+        std::size_t storageBytes() const noexcept { return words.size() * sizeof(neko::uint64); }
+
+        /**
+         * @brief Atomically read an item.
+         */
+        State get(std::size_t index) const noexcept {
+            return static_cast<State>((loadWord(index) >> shiftOf(index)) & 3);
+        }
+
+        State operator[](std::size_t index) const noexcept {
+            return get(index);
+        }
+
+        /**
+         * @brief Atomically replace an item.
+         * @return The previous state.
+         */
+        State exchange(std::size_t index, State state) noexcept {
+            auto ref = wordRef(index);
+            const auto shift = shiftOf(index);
+            const auto mask = neko::uint64{3} << shift;
+            const auto bits = static_cast<neko::uint64>(state) << shift;
+            auto word = ref.load(std::memory_order_relaxed);
+            while (!ref.compare_exchange_weak(word, (word & ~mask) | bits, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+            }
+            return static_cast<State>((word >> shift) & 3);
+        }
+
+        /**
+         * @brief Atomically set an item.
+         */
+        void set(std::size_t index, State state) noexcept {
+            (void)exchange(index, state);
+        }
+
+        /**
+         * @brief Atomically set an item if it currently holds expected.
+         * @param expected Updated with the current state on failure.
+         * @return True if the item was replaced.
+         */
+        bool compareExchange(std::size_t index, State &expected, State desired) noexcept {
+            auto ref = wordRef(index);
+            const auto shift = shiftOf(index);
+            const auto mask = neko::uint64{3} << shift;
+            auto word = ref.load(std::memory_order_relaxed);
+            while (true) {
+                const auto current = static_cast<State>((word >> shift) & 3);
+                if (current != expected) {
+                    expected = current;
+                    return false;
+                }
+                const auto next = (word & ~mask) | (static_cast<neko::uint64>(desired) << shift);
+                if (ref.compare_exchange_weak(word, next, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                    return true;
+                }
+            }
+        }
+
+        /**
+         * @brief Count every state in one pass.
+         * @return Counts indexed by the State value.
+         */
+        std::array<std::size_t, 4> countAll() const noexcept {
+            // Per word: both bits set -> Failed, high bit -> Retry or Failed, low bit -> Action or Failed
+            std::size_t both = 0;
+            std::size_t high = 0;
+            std::size_t low = 0;
+            for (const auto word : words) {
+                both += static_cast<std::size_t>(std::popcount(word & (word >> 1) & lowBits));
+                high += static_cast<std::size_t>(std::popcount(word & highBits));
+                low += static_cast<std::size_t>(std::popcount(word & lowBits));
+            }
+            // Padding lanes are zero, i.e. never counted in high / low / both
+            const std::size_t failed = both;
+            const std::size_t retry = high - both;
+            const std::size_t action = low - both;
+            return {itemCount - failed - retry - action, action, retry, failed};
+        }
+
+        /**
+         * @brief Count the items holding state.
+         */
+        std::size_t count(State state) const noexcept {
+            return countAll()[static_cast<std::size_t>(state)];
+        }
+
+        /**
+         * @brief Find the next item holding state.
+         * @param state State to search for.
+         * @param from First index to inspect.
+         * @return Index of the item, npos if none.
+         */
+        std::size_t findNext(State state, std::size_t from = 0) const noexcept {
+            return findFirst(from, [state](neko::uint64 word) { return lanesEqual(word, state); });
+        }
+
+        /**
+         * @brief Find the next item that is RetryRequired or Failed.
+         * @param from First index to inspect.
+         * @return Index of the item, npos if none.
+         */
+        std::size_t findNextFailure(std::size_t from = 0) const noexcept {
+            // RetryRequired (2) and Failed (3) are exactly the lanes with the high bit set
+            return findFirst(from, [](neko::uint64 word) { return word & highBits; });
+        }
+
+        /**
+         * @brief Merge the results of another worker, keeping the worst state of each item.
+         * @details States are ordered Completed < ActionNeeded < RetryRequired < Failed,
+         * so workers that only touch their own items can each start from Completed.
+         * @param other Vector of the same size.
+         * @param srcLoc Source location information.
+         * @throws neko::ex::ArgumentError if the sizes differ.
+         */
+        void merge(const StateVector &other, const neko::SrcLocInfo &srcLoc = {}) {
+            if (other.itemCount != itemCount) {
+                neko::raise<neko::ex::ArgumentError>("StateVector sizes differ!", srcLoc);
+            }
+            for (std::size_t i = 0; i < words.size(); ++i) {
+                const auto a = words[i];
+                const auto b = other.words[i];
+                // Lanes where only one side has the high bit set take that side, others take a | b
+                const auto aWins = (a & ~b) & highBits;
+                const auto bWins = (b & ~a) & highBits;
+                const auto aMask = aWins | (aWins >> 1);
+                const auto bMask = bWins | (bWins >> 1);
+                words[i] = (a & aMask) | (b & bMask) | ((a | b) & ~(aMask | bMask));
+            }
+        }
+    };
+
+} // namespace neko
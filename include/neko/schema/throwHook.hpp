@@ -0,0 +1,182 @@
+/**
+ * @file throwHook.hpp
+ * @brief Process-wide hooks called whenever a neko::ex::Exception is constructed
+ * @details Hooks receive the error kind, the message and the source location,
+ * which makes them suitable for tracing, metrics and crash breadcrumbs.
+ * When no hook is installed, constructing an exception costs one relaxed atomic load and a branch.
+ */
+#pragma once
+
+#if !defined(NEKO_SCHEMA_ENABLE_MODULE) || (NEKO_SCHEMA_ENABLE_MODULE == false)
+#include <neko/schema/types.hpp>
+#include <neko/schema/exception.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#endif // !NEKO_SCHEMA_ENABLE_MODULE
+
+#if !defined(NEKO_SCHEMA_REGISTRY_API)
+    // Module partitions do not see the macros of exception.hpp, and are always header-only
+    #define NEKO_SCHEMA_REGISTRY_API inline
+#endif
+
+namespace neko::ex {
+
+    /**
+     * @brief Identifier of an installed hook, 0 is never used.
+     */
+    using ThrowHookId = neko::uint64;
+
+    /**
+     * @brief Install a hook called on every neko::ex::Exception construction.
+     * @param hook Callback, invoked on the constructing thread.
+     * @param userData Opaque pointer passed back to the hook.
+     * @return Identifier used to remove the hook.
+     * @note Registration is meant to be rare, each change keeps a small snapshot alive for the process lifetime.
+     */
+    NEKO_SCHEMA_REGISTRY_API ThrowHookId addThrowHook(ThrowHook hook, void *userData = nullptr);
+
+    /**
+     * @brief Remove a hook installed with addThrowHook.
+     * @param id Identifier returned by addThrowHook.
+     * @return True if the hook was installed.
+     * @note Returns once no concurrent exception construction is still calling the hook, so its userData
+     * may be destroyed afterwards. Must not be called from a hook.
+     */
+    NEKO_SCHEMA_REGISTRY_API bool removeThrowHook(ThrowHookId id);
+
+    /**
+     * @brief Check if any hook is installed.
+     * @return True if at least one hook is installed.
+     */
+    inline bool hasThrowHooks() noexcept {
+        const auto *list = detail::throwHooks.load(std::memory_order_acquire);
+        return list != nullptr && list->count != 0;
+    }
+
+    namespace detail {
+
+        /**
+         * @brief Install the release hook, or remove it with nullptr.
+         * @note Published in the same snapshot as the throw hooks, so constructions still check a single pointer.
+         */
+        NEKO_SCHEMA_REGISTRY_API void setReleaseHook(ReleaseHook hook);
+
+        /**
+         * @brief Get the installed release hook, nullptr if none.
+         */
+        inline ReleaseHook getReleaseHook() noexcept {
+            const auto *list = throwHooks.load(std::memory_order_acquire);
+            return list != nullptr ? list->release : nullptr;
+        }
+
+    } // namespace detail
+
+#if !defined(NEKO_SCHEMA_COMPILED) || defined(NEKO_SCHEMA_COMPILED_SOURCE)
+
+    namespace detail {
+
+        struct ThrowHookSnapshot {
+            std::vector<ThrowHookEntry> entries;
+            ThrowHookList list;
+        };
+
+        struct ThrowHookRegistry {
+            std::mutex mutex;
+            std::vector<ThrowHookEntry> entries;
+            // Snapshots may still be read by concurrent exception constructions, so they are kept for the process lifetime
+            std::vector<std::unique_ptr<ThrowHookSnapshot>> snapshots;
+            ReleaseHook release = nullptr;
+            ThrowHookId nextId = 1;
+
+            void publish() {
+                if (entries.empty() && release == nullptr) {
+                    throwHooks.store(nullptr, std::memory_order_release);
+                    return;
+                }
+                auto snapshot = std::make_unique<ThrowHookSnapshot>();
+                snapshot->entries = entries;
+                snapshot->list.entries = snapshot->entries.data();
+                snapshot->list.count = snapshot->entries.size();
+                snapshot->list.release = release;
+                throwHooks.store(&snapshot->list, std::memory_order_release);
+                snapshots.push_back(std::move(snapshot));
+            }
+
+            /**
+             * @brief Snapshots replaced by the last publish(), called with mutex held.
+             */
+            std::vector<const ThrowHookList *> stale() const {
+                const auto *current = throwHooks.load(std::memory_order_relaxed);
+                std::vector<const ThrowHookList *> result;
+                for (const auto &snapshot : snapshots) {
+                    if (&snapshot->list != current) {
+                        result.push_back(&snapshot->list);
+                    }
+                }
+                return result;
+            }
+        };
+
+        /**
+         * @brief Wait for the constructions still calling the hooks of replaced snapshots.
+         * @details New constructions only enter the current snapshot, so each wait is bounded by one hook call.
+         */
+        inline void quiesce(const std::vector<const ThrowHookList *> &lists) noexcept {
+            for (const auto *list : lists) {
+                while (list->readers.load(std::memory_order_seq_cst) != 0) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+        inline ThrowHookRegistry &throwHookRegistry() {
+            // Intentionally leaked: exceptions may be constructed during static destruction
+            static auto *registry = new ThrowHookRegistry();
+            return *registry;
+        }
+
+        NEKO_SCHEMA_REGISTRY_API void setReleaseHook(ReleaseHook hook) {
+            auto &registry = throwHookRegistry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            registry.release = hook;
+            registry.publish();
+        }
+
+    } // namespace detail
+
+    NEKO_SCHEMA_REGISTRY_API ThrowHookId addThrowHook(ThrowHook hook, void *userData) {
+        auto &registry = detail::throwHookRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        const ThrowHookId id = registry.nextId++;
+        registry.entries.push_back(detail::ThrowHookEntry{hook, userData, id});
+        registry.publish();
+        return id;
+    }
+
+    NEKO_SCHEMA_REGISTRY_API bool removeThrowHook(ThrowHookId id) {
+        auto &registry = detail::throwHookRegistry();
+        std::vector<const detail::ThrowHookList *> stale;
+        {
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            const auto it = std::find_if(registry.entries.begin(), registry.entries.end(),
+                                         [id](const detail::ThrowHookEntry &entry) { return entry.id == id; });
+            if (it == registry.entries.end()) {
+                return false;
+            }
+            registry.entries.erase(it);
+            registry.publish();
+            stale = registry.stale();
+        }
+        // Outside the lock, a running hook may itself add a hook
+        detail::quiesce(stale);
+        return true;
+    }
+
+#endif // !NEKO_SCHEMA_COMPILED || NEKO_SCHEMA_COMPILED_SOURCE
+
+} // namespace neko::ex
@@ -0,0 +1,320 @@
+/**
+ * @file throwSites.hpp
+ * @brief Top-K hot throw sites, for finding the errors worth turning into non-throwing paths
+ * @details While sampling is on, each neko::ex::Exception is stamped at construction and, when destroyed
+ * (i.e. after it was caught), its site and cost in cycles are fed into a bounded space-saving sketch owned
+ * by the calling thread. The thread sketches, and the one retired from exited threads, are merged on demand
+ * into the top-K sites with estimated counts, their maximum overestimation and the cumulative cost.
+ */
+#pragma once
+
+#if !defined(NEKO_SCHEMA_ENABLE_MODULE) || (NEKO_SCHEMA_ENABLE_MODULE == false)
+#include <neko/schema/types.hpp>
+#include <neko/schema/srcLoc.hpp>
+#include <neko/schema/exception.hpp>
+#include <neko/schema/throwHook.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+#endif // !NEKO_SCHEMA_ENABLE_MODULE
+
+#if !defined(NEKO_SCHEMA_REGISTRY_API)
+    // Module partitions do not see the macros of exception.hpp, and are always header-only
+    #define NEKO_SCHEMA_REGISTRY_API inline
+#endif
+
+namespace neko::metrics {
+
+    /**
+     * @brief Estimated statistics of one throw site.
+     */
+    struct ThrowSite {
+        neko::SrcLocInfo site{nullptr, 0, nullptr};
+        /// Kind of the first exception seen at the site
+        neko::ex::ErrorKind kind = neko::ex::ErrorKind::Exception;
+        /// Estimated number of exceptions, never below the true count
+        neko::uint64 count = 0;
+        /// Maximum overestimation of count
+        neko::uint64 error = 0;
+        /// Cumulative cycles from construction to destruction
+        neko::uint64 cycles = 0;
+    };
+
+    /**
+     * @brief Space-saving heavy hitters sketch of throw sites.
+     * @details Keeps at most capacity sites. A new site evicts the smallest one and inherits its count as
+     * overestimation, so any site thrown more than total / capacity times is guaranteed to be kept.
+     */
+    class SpaceSaving {
+    private:
+        std::vector<ThrowSite> entries;
+        std::size_t capacity;
+
+        // Sites are identified by their static strings and line, as produced by std::source_location
+        static bool sameSite(const neko::SrcLocInfo &a, const neko::SrcLocInfo &b) noexcept {
+            return a.getLine() == b.getLine() && a.getFile() == b.getFile() && a.getFunc() == b.getFunc();
+        }
+
+        const ThrowSite *find(const neko::SrcLocInfo &site) const noexcept {
+            const auto it = std::find_if(entries.begin(), entries.end(), [&site](const ThrowSite &entry) { return sameSite(entry.site, site); });
+            return it != entries.end() ? &*it : nullptr;
+        }
+
+        neko::uint64 minCount() const noexcept {
+            if (entries.size() < capacity || entries.empty()) {
+                return 0;
+            }
+            return std::min_element(entries.begin(), entries.end(), [](const ThrowSite &a, const ThrowSite &b) { return a.count < b.count; })->count;
+        }
+
+    public:
+        explicit SpaceSaving(std::size_t Capacity = 64)
+            : capacity(std::max<std::size_t>(Capacity, 1)) {
+            entries.reserve(capacity);
+        }
+
+        /**
+         * @brief Record exceptions of a site, without allocating.
+         * @param kind Error kind.
+         * @param site Source location of the exceptions.
+         * @param count Number of exceptions.
+         * @param cycles Their total cost.
+         */
+        void add(neko::ex::ErrorKind kind, const neko::SrcLocInfo &site, neko::uint64 count, neko::uint64 cycles) noexcept {
+            if (auto *entry = const_cast<ThrowSite *>(find(site))) {
+                entry->count += count;
+                entry->cycles += cycles;
+                return;
+            }
+            if (entries.size() < capacity) {
+                entries.push_back(ThrowSite{site, kind, count, 0, cycles});
+                return;
+            }
+            auto &smallest = *std::min_element(entries.begin(), entries.end(), [](const ThrowSite &a, const ThrowSite &b) { return a.count < b.count; });
+            smallest = ThrowSite{site, kind, smallest.count + count, smallest.count, cycles};
+        }
+
+        /**
+         * @brief Merge another sketch, keeping the error bounds of both.
+         */
+        void merge(const SpaceSaving &other) {
+            const auto ownMin = minCount();
+            const auto otherMin = other.minCount();
+            std::vector<ThrowSite> merged = entries;
+            for (auto &entry : merged) {
+                if (const auto *match = other.find(entry.site)) {
+                    entry.count += match->count;
+                    entry.error += match->error;
+                    entry.cycles += match->cycles;
+                } else {
+                    // Possibly evicted from the other sketch with up to its minimum count
+                    entry.count += otherMin;
+                    entry.error += otherMin;
+                }
+            }
+            for (const auto &entry : other.entries) {
+                if (find(entry.site) == nullptr) {
+                    merged.push_back(entry);
+                    merged.back().count += ownMin;
+                    merged.back().error += ownMin;
+                }
+            }
+            std::sort(merged.begin(), merged.end(), [](const ThrowSite &a, const ThrowSite &b) { return a.count > b.count; });
+            if (merged.size() > capacity) {
+                merged.resize(capacity);
+            }
+            entries = std::move(merged);
+        }
+
+        /**
+         * @brief The k sites with the highest estimated counts.
+         */
+        std::vector<ThrowSite> top(std::size_t k) const {
+            std::vector<ThrowSite> result = entries;
+            std::sort(result.begin(), result.end(), [](const ThrowSite &a, const ThrowSite &b) { return a.count > b.count; });
+            if (result.size() > k) {
+                result.resize(k);
+            }
+            return result;
+        }
+
+        void clear() noexcept { entries.clear(); }
+        std::size_t size() const noexcept { return entries.size(); }
+        std::size_t getCapacity() const noexcept { return capacity; }
+    };
+
+    /**
+     * @brief Throw site sampling settings.
+     */
+    struct ThrowSamplerConfig {
+        /// Sites kept per thread and in the merged report
+        std::size_t capacity = 64;
+        /// Record one exception out of sampleEvery per thread, counts and cycles are scaled back up
+        neko::uint32 sampleEvery = 1;
+    };
+
+    /**
+     * @brief Start sampling the sites of every neko::ex::Exception.
+     * @note Only exceptions constructed after this call are stamped and recorded. The calling thread's sketch
+     * is allocated here, other threads allocate theirs on their first sample.
+     */
+    NEKO_SCHEMA_REGISTRY_API void startThrowSampling(const ThrowSamplerConfig &config = {});
+
+    /**
+     * @brief Stop sampling, the recorded sites are kept.
+     */
+    NEKO_SCHEMA_REGISTRY_API void stopThrowSampling();
+
+    NEKO_SCHEMA_REGISTRY_API bool isThrowSampling() noexcept;
+
+    /**
+     * @brief Merge every thread's sketch and report the hottest sites.
+     * @param k Number of sites to report.
+     * @return Sites ordered by estimated count, highest first.
+     */
+    NEKO_SCHEMA_REGISTRY_API std::vector<ThrowSite> topThrowSites(std::size_t k = 10);
+
+    /**
+     * @brief Forget every recorded site.
+     */
+    NEKO_SCHEMA_REGISTRY_API void resetThrowSites();
+
+#if !defined(NEKO_SCHEMA_COMPILED) || defined(NEKO_SCHEMA_COMPILED_SOURCE)
+
+    namespace detail {
+
+        struct ThrowSiteShard {
+            std::mutex mutex; // Guards the sketch against topThrowSites()
+            SpaceSaving sketch;
+            neko::uint32 tick = 0; // Owner thread only
+
+            explicit ThrowSiteShard(std::size_t capacity)
+                : sketch(capacity) {}
+        };
+
+        struct ThrowSiteRegistry {
+            std::mutex mutex;
+            std::vector<std::shared_ptr<ThrowSiteShard>> shards;
+            std::atomic<std::size_t> capacity{64};
+            std::atomic<neko::uint32> sampleEvery{1};
+            // Sites of exited threads, merged from their shards
+            SpaceSaving retired;
+        };
+
+        inline ThrowSiteRegistry &throwSiteRegistry() {
+            // Intentionally leaked: exceptions may be destroyed during static destruction
+            static auto *registry = new ThrowSiteRegistry();
+            return *registry;
+        }
+
+        /**
+         * @brief Merge the shards of exited threads into the retired sketch and drop them.
+         * @note Called with the registry mutex held.
+         */
+        inline void retireExited(ThrowSiteRegistry &registry) {
+            std::erase_if(registry.shards, [&registry](const std::shared_ptr<ThrowSiteShard> &shard) {
+                // Only referenced by the registry: the owning thread has exited
+                if (shard.use_count() != 1) {
+                    return false;
+                }
+                std::atomic_thread_fence(std::memory_order_acquire); // Pairs with the owner's release of its reference
+                if (registry.retired.size() == 0) {
+                    registry.retired = SpaceSaving(registry.capacity.load(std::memory_order_relaxed));
+                }
+                registry.retired.merge(shard->sketch);
+                return true;
+            });
+        }
+
+        inline std::shared_ptr<ThrowSiteShard> registerThrowSiteShard() {
+            auto &registry = throwSiteRegistry();
+            auto shard = std::make_shared<ThrowSiteShard>(registry.capacity.load(std::memory_order_relaxed));
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            // Bounds the registry under thread churn even if topThrowSites() is never called
+            retireExited(registry);
+            registry.shards.push_back(shard);
+            return shard;
+        }
+
+        /**
+         * @brief Shard of the calling thread, empty until registered.
+         * @note The registry shares ownership until the thread exits, then its sites are retired.
+         */
+        inline std::shared_ptr<ThrowSiteShard> &localThrowSiteShard() noexcept {
+            thread_local std::shared_ptr<ThrowSiteShard> shard;
+            return shard;
+        }
+
+        inline void onRelease(neko::ex::ErrorKind kind, const neko::SrcLocInfo &srcLoc, neko::uint64 cycles) noexcept {
+            auto &shard = localThrowSiteShard();
+            if (shard == nullptr) [[unlikely]] {
+                // First exception of a thread other than the one that started sampling
+#if defined(__cpp_exceptions) || defined(_CPPUNWIND)
+                try {
+                    shard = registerThrowSiteShard();
+                } catch (...) {
+                    return; // Drop the sample, this runs in a destructor
+                }
+#else
+                shard = registerThrowSiteShard();
+#endif
+            }
+            const auto every = throwSiteRegistry().sampleEvery.load(std::memory_order_relaxed);
+            if (++shard->tick < every) {
+                return;
+            }
+            shard->tick = 0;
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            shard->sketch.add(kind, srcLoc, every, cycles * every);
+        }
+
+    } // namespace detail
+
+    NEKO_SCHEMA_REGISTRY_API void startThrowSampling(const ThrowSamplerConfig &config) {
+        auto &registry = detail::throwSiteRegistry();
+        registry.capacity.store(std::max<std::size_t>(config.capacity, 1), std::memory_order_relaxed);
+        registry.sampleEvery.store(std::max<neko::uint32>(config.sampleEvery, 1), std::memory_order_relaxed);
+        if (auto &shard = detail::localThrowSiteShard(); shard == nullptr) {
+            shard = detail::registerThrowSiteShard();
+        }
+        neko::ex::detail::setReleaseHook(&detail::onRelease);
+    }
+
+    NEKO_SCHEMA_REGISTRY_API void stopThrowSampling() {
+        neko::ex::detail::setReleaseHook(nullptr);
+    }
+
+    NEKO_SCHEMA_REGISTRY_API bool isThrowSampling() noexcept {
+        return neko::ex::detail::getReleaseHook() == &detail::onRelease;
+    }
+
+    NEKO_SCHEMA_REGISTRY_API std::vector<ThrowSite> topThrowSites(std::size_t k) {
+        auto &registry = detail::throwSiteRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        detail::retireExited(registry);
+        SpaceSaving merged(registry.capacity.load(std::memory_order_relaxed));
+        merged.merge(registry.retired);
+        for (const auto &shard : registry.shards) {
+            std::lock_guard<std::mutex> shardLock(shard->mutex);
+            merged.merge(shard->sketch);
+        }
+        return merged.top(k);
+    }
+
+    NEKO_SCHEMA_REGISTRY_API void resetThrowSites() {
+        auto &registry = detail::throwSiteRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.retired.clear();
+        for (const auto &shard : registry.shards) {
+            std::lock_guard<std::mutex> shardLock(shard->mutex);
+            shard->sketch.clear();
+        }
+    }
+
+#endif // !NEKO_SCHEMA_COMPILED || NEKO_SCHEMA_COMPILED_SOURCE
+
+} // namespace neko::metrics
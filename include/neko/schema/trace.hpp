@@ -0,0 +1,301 @@
+/**
+ * @file trace.hpp
+ * @brief Lightweight scoped tracing spans keyed by neko::SrcLocInfo
+ * @details Each thread writes finished spans into its own lock-free ring buffer,
+ * with no allocation and no locks on the hot path. A thread's ring is registered when its first span starts.
+ * The rings are drained on demand and can be exported as Chrome trace JSON (chrome://tracing, Perfetto).
+ */
+#pragma once
+
+#if !defined(NEKO_SCHEMA_ENABLE_MODULE) || (NEKO_SCHEMA_ENABLE_MODULE == false)
+#include <neko/schema/types.hpp>
+#include <neko/schema/srcLoc.hpp>
+#include <neko/schema/cycles.hpp>
+
+#include <atomic>
+#include <charconv>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <span>
+#include <vector>
+#endif // !NEKO_SCHEMA_ENABLE_MODULE
+
+/**
+ * @brief Tracing spans
+ * @namespace neko::trace
+ */
+namespace neko::trace {
+
+    /**
+     * @brief A finished span.
+     * @note Times are steady clock nanoseconds; name, file and func point to static strings of the call site.
+     */
+    struct SpanRecord {
+        neko::uint64 begin = 0;
+        neko::uint64 end = 0;
+        neko::cstr name = nullptr;
+        neko::cstr file = nullptr;
+        neko::cstr func = nullptr;
+        neko::uint32 line = 0;
+        neko::uint32 threadId = 0;
+    };
+
+    namespace detail {
+
+        /**
+         * @brief Single-producer single-consumer ring of spans.
+         * @details The owning thread pushes, the drainer pops under the registry lock.
+         * When the ring is full new spans are dropped and counted.
+         */
+        struct ThreadRing {
+            static constexpr std::size_t capacity = std::size_t{1} << 14;
+
+            std::unique_ptr<SpanRecord[]> slots{new SpanRecord[capacity]};
+            neko::uint32 threadId = 0;
+            alignas(64) std::atomic<neko::uint64> head{0};
+            alignas(64) std::atomic<neko::uint64> tail{0};
+            std::atomic<neko::uint64> dropped{0};
+
+            void push(const SpanRecord &record) noexcept {
+                const auto h = head.load(std::memory_order_relaxed);
+                if (h - tail.load(std::memory_order_acquire) >= capacity) [[unlikely]] {
+                    dropped.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                slots[h & (capacity - 1)] = record;
+                head.store(h + 1, std::memory_order_release);
+            }
+
+            std::size_t drainTo(std::vector<SpanRecord> &out) {
+                const auto t = tail.load(std::memory_order_relaxed);
+                const auto h = head.load(std::memory_order_acquire);
+                for (auto i = t; i != h; ++i) {
+                    out.push_back(slots[i & (capacity - 1)]);
+                    out.back().threadId = threadId;
+                }
+                tail.store(h, std::memory_order_release);
+                return static_cast<std::size_t>(h - t);
+            }
+        };
+
+        struct TraceRegistry {
+            std::mutex mutex;
+            std::vector<std::shared_ptr<ThreadRing>> rings;
+            neko::uint32 nextThreadId = 1;
+            neko::uint64 retiredDropped = 0;
+        };
+
+        inline TraceRegistry &traceRegistry() {
+            // Intentionally leaked: spans may end during static destruction
+            static auto *registry = new TraceRegistry();
+            return *registry;
+        }
+
+        /**
+         * @brief Drop the rings of exited threads that hold no unread span, keeping their dropped counts.
+         * @note Called with the registry mutex held. Rings with unread spans wait for the next drain.
+         */
+        inline void retireExited(TraceRegistry &registry) {
+            std::erase_if(registry.rings, [&registry](const std::shared_ptr<ThreadRing> &ring) {
+                // Only referenced by the registry: the owning thread has exited
+                if (ring.use_count() != 1) {
+                    return false;
+                }
+                std::atomic_thread_fence(std::memory_order_acquire); // Pairs with the owner's release of its reference
+                if (ring->head.load(std::memory_order_relaxed) != ring->tail.load(std::memory_order_relaxed)) {
+                    return false;
+                }
+                registry.retiredDropped += ring->dropped.load(std::memory_order_relaxed);
+                return true;
+            });
+        }
+
+        inline std::shared_ptr<ThreadRing> registerRing() {
+            auto ring = std::make_shared<ThreadRing>();
+            auto &registry = traceRegistry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            // Bounds the registry under thread churn even if drain() is rarely called
+            retireExited(registry);
+            ring->threadId = registry.nextThreadId++;
+            registry.rings.push_back(ring);
+            return ring;
+        }
+
+        /**
+         * @brief Ring of the calling thread, registered on first use.
+         * @return nullptr if the ring could not be allocated, the span is then not recorded.
+         */
+        inline ThreadRing *localRing() noexcept {
+            // The registry shares ownership until the thread exits, then the ring is retired once drained
+            thread_local std::shared_ptr<ThreadRing> ring;
+            if (ring == nullptr) [[unlikely]] {
+#if defined(__cpp_exceptions) || defined(_CPPUNWIND)
+                try {
+                    ring = registerRing();
+                } catch (...) {
+                    return nullptr;
+                }
+#else
+                ring = registerRing();
+#endif
+            }
+            return ring.get();
+        }
+
+        inline std::atomic<bool> enabled{false};
+
+        inline void writeJsonString(std::ostream &os, neko::cstr text) {
+            os << '"';
+            for (neko::cstr p = text ? text : ""; *p != '\0'; ++p) {
+                const auto c = static_cast<neko::uchar>(*p);
+                if (c == '"' || c == '\\') {
+                    os << '\\' << static_cast<char>(c);
+                } else if (c < 0x20) {
+                    constexpr neko::cstr hex = "0123456789abcdef";
+                    os << "\\u00" << hex[c >> 4] << hex[c & 0xF];
+                } else {
+                    os << static_cast<char>(c);
+                }
+            }
+            os << '"';
+        }
+
+        // Chrome trace times are microseconds, written with nanosecond precision
+        inline void writeMicros(std::ostream &os, neko::uint64 ns) {
+            char buf[32];
+            auto *p = std::to_chars(buf, buf + sizeof(buf), ns / 1000).ptr;
+            const auto frac = static_cast<unsigned>(ns % 1000);
+            *p++ = '.';
+            *p++ = static_cast<char>('0' + frac / 100);
+            *p++ = static_cast<char>('0' + frac / 10 % 10);
+            *p++ = static_cast<char>('0' + frac % 10);
+            os.write(buf, p - buf);
+        }
+
+    } // namespace detail
+
+    /**
+     * @brief Enable or disable span recording process-wide (disabled by default).
+     */
+    inline void setEnabled(bool enable) noexcept {
+        detail::enabled.store(enable, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Check if span recording is enabled.
+     */
+    inline bool isEnabled() noexcept {
+        return detail::enabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Scoped span, recorded into the thread's ring when it goes out of scope.
+     *
+     * @code
+     * void handleRequest() {
+     *     neko::trace::Span span;            // named after the enclosing function
+     *     neko::trace::Span parse("parse");  // or with an explicit static name
+     * }
+     * @endcode
+     */
+    class Span {
+    private:
+        neko::SrcLocInfo site;
+        neko::cstr name;
+        detail::ThreadRing *ring = nullptr; // Set when recording
+        neko::uint64 begin = 0;
+
+    public:
+        /**
+         * @brief Start a span.
+         * @param Name Static span name, defaults to the function name of the call site.
+         * @param SrcLoc Source location information.
+         */
+        explicit Span(neko::cstr Name = nullptr, const neko::SrcLocInfo &SrcLoc = {}) noexcept
+            : site(SrcLoc), name(Name) {
+            if (isEnabled()) {
+                // Registering here keeps allocation and locking out of the destructor
+                ring = detail::localRing();
+                begin = neko::monotonicNs();
+            }
+        }
+
+        Span(const Span &) = delete;
+        Span &operator=(const Span &) = delete;
+
+        ~Span() {
+            if (ring != nullptr) {
+                const auto end = neko::monotonicNs();
+                ring->push(SpanRecord{begin, end, name, site.getFile(), site.getFunc(), site.getLine(), 0});
+            }
+        }
+    };
+
+    /**
+     * @brief Move all finished spans of every thread into out.
+     * @param out Spans are appended to it, ordered per thread.
+     * @return Number of spans appended.
+     */
+    inline std::size_t drain(std::vector<SpanRecord> &out) {
+        auto &registry = detail::traceRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        std::size_t count = 0;
+        for (const auto &ring : registry.rings) {
+            count += ring->drainTo(out);
+        }
+        // A thread may push after its ring was drained and then exit, so only empty rings are retired
+        detail::retireExited(registry);
+        return count;
+    }
+
+    /**
+     * @brief Number of spans dropped because a thread's ring was full.
+     */
+    inline neko::uint64 droppedCount() {
+        auto &registry = detail::traceRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        neko::uint64 dropped = registry.retiredDropped;
+        for (const auto &ring : registry.rings) {
+            dropped += ring->dropped.load(std::memory_order_relaxed);
+        }
+        return dropped;
+    }
+
+    /**
+     * @brief Write spans as a Chrome trace JSON document of complete ("X") events.
+     * @param os Output stream.
+     * @param records Spans to write.
+     */
+    inline void writeChromeTrace(std::ostream &os, std::span<const SpanRecord> records) {
+        os << "{\"traceEvents\":[";
+        bool first = true;
+        for (const auto &record : records) {
+            os << (first ? "\n" : ",\n") << "{\"name\":";
+            detail::writeJsonString(os, record.name ? record.name : record.func);
+            os << ",\"cat\":\"neko\",\"ph\":\"X\",\"ts\":";
+            detail::writeMicros(os, record.begin);
+            os << ",\"dur\":";
+            detail::writeMicros(os, record.end - record.begin);
+            os << ",\"pid\":1,\"tid\":" << record.threadId << ",\"args\":{\"file\":";
+            detail::writeJsonString(os, record.file);
+            os << ",\"line\":" << record.line << "}}";
+            first = false;
+        }
+        os << "\n],\"displayTimeUnit\":\"ns\"}\n";
+    }
+
+    /**
+     * @brief Drain all threads and write the spans as Chrome trace JSON.
+     * @param os Output stream.
+     * @return Number of spans written.
+     */
+    inline std::size_t drainChromeTrace(std::ostream &os) {
+        std::vector<SpanRecord> records;
+        drain(records);
+        writeChromeTrace(os, records);
+        return records.size();
+    }
+
+} // namespace neko::trace
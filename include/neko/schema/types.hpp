@@ -88,6 +88,16 @@ namespace neko {
                     return "Unknown";
             }
         }
+        inline neko::cstr toString(SyncMode mode) {
+            switch (mode) {
+                case SyncMode::Sync:
+                    return "Sync";
+                case SyncMode::Async:
+                    return "Async";
+                default:
+                    return "Unknown";
+            }
+        }
     } // namespace types
 
 } // namespace neko
@@ -0,0 +1,50 @@
+/**
+ * @file exception.cpp
+ * @brief Key functions of the exception classes for the compiled library (Neko::Schema::Compiled)
+ * @details Defining the destructors here emits every vtable and typeinfo once, in this translation unit.
+ * The throw hook and throw site registries are defined here too, so every module of a program shares them.
+ */
+
+// Compile the out-of-line registry definitions of throwHook.hpp and throwSites.hpp
+#define NEKO_SCHEMA_COMPILED_SOURCE
+
+#include <neko/schema/exception.hpp>
+#include <neko/schema/throwHook.hpp>
+#include <neko/schema/throwSites.hpp>
+
+#if !defined(NEKO_SCHEMA_COMPILED)
+#error "exception.cpp is only built as part of NekoSchema_compiled (NEKO_SCHEMA_COMPILED)"
+#endif
+
+namespace neko::ex {
+
+    namespace detail {
+        std::atomic<const ThrowHookList *> throwHooks{nullptr};
+    } // namespace detail
+
+    Exception::~Exception() {
+        releaseStamp();
+    }
+
+    ProgramExit::~ProgramExit() = default;
+    LogicError::~LogicError() = default;
+    ArgumentError::~ArgumentError() = default;
+    RangeError::~RangeError() = default;
+    NotSupported::~NotSupported() = default;
+    InvalidState::~InvalidState() = default;
+    AssertionFailure::~AssertionFailure() = default;
+    DuplicateError::~DuplicateError() = default;
+    RuntimeError::~RuntimeError() = default;
+    ConfigurationError::~ConfigurationError() = default;
+    ParseError::~ParseError() = default;
+    ConcurrencyError::~ConcurrencyError() = default;
+    TaskRejectedError::~TaskRejectedError() = default;
+    PermissionDeniedError::~PermissionDeniedError() = default;
+    TimeoutError::~TimeoutError() = default;
+    SystemError::~SystemError() = default;
+    FileError::~FileError() = default;
+    NetworkError::~NetworkError() = default;
+    DatabaseError::~DatabaseError() = default;
+    ExternalDependencyError::~ExternalDependencyError() = default;
+
+} // namespace neko::ex
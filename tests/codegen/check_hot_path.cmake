@@ -0,0 +1,47 @@
+# Compares the code size of the two probes in hot_path.cpp.
+# Usage: cmake -DNM=<nm> -DOBJECTS=<objects> -P check_hot_path.cmake
+#
+# A function's size includes its split-off fragments (e.g. GCC's "name.cold"), so moving code between
+# sections does not count as shrinking. The raise probe must be smaller in total and its hot part must not grow.
+
+if(NOT NM OR NOT OBJECTS)
+    message(FATAL_ERROR "NM and OBJECTS are required")
+endif()
+
+execute_process(
+    COMMAND ${NM} -S ${OBJECTS}
+    OUTPUT_VARIABLE symbols
+    RESULT_VARIABLE result
+)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "${NM} failed on ${OBJECTS}")
+endif()
+
+function(probe_size name outTotal outHot)
+    set(total 0)
+    set(hot 0)
+    string(REPLACE "\n" ";" lines "${symbols}")
+    foreach(line IN LISTS lines)
+        if(line MATCHES "^[0-9a-fA-F]+ ([0-9a-fA-F]+) [tTwW] _?(${name}(\\..*)?)$")
+            math(EXPR size "0x${CMAKE_MATCH_1}")
+            math(EXPR total "${total} + ${size}")
+            if(CMAKE_MATCH_2 STREQUAL name)
+                set(hot ${size})
+            endif()
+        endif()
+    endforeach()
+    if(hot EQUAL 0)
+        message(FATAL_ERROR "Symbol ${name} not found in ${OBJECTS}")
+    endif()
+    set(${outTotal} ${total} PARENT_SCOPE)
+    set(${outHot} ${hot} PARENT_SCOPE)
+endfunction()
+
+probe_size(neko_hot_path_inline inlineTotal inlineHot)
+probe_size(neko_hot_path_raise raiseTotal raiseHot)
+message(STATUS "throw expression: ${inlineTotal} bytes (${inlineHot} in the hot part)")
+message(STATUS "neko::raise:      ${raiseTotal} bytes (${raiseHot} in the hot part)")
+
+if(NOT raiseTotal LESS inlineTotal OR raiseHot GREATER inlineHot)
+    message(FATAL_ERROR "neko::raise does not shrink the caller")
+endif()
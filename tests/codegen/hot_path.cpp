@@ -0,0 +1,37 @@
+/**
+ * @file hot_path.cpp
+ * @brief Codegen probe: the same bounds-checked loop raising inline and through neko::raise
+ * @details Built at -O2 as an object library, check_hot_path.cmake compares the symbol sizes of the two
+ * hot functions. Both are extern "C" so their names are stable across compilers.
+ */
+#include <neko/schema/exception.hpp>
+#include <neko/schema/raise.hpp>
+
+#include <cstddef>
+#include <string>
+
+extern "C" {
+
+    long long neko_hot_path_inline(const int *values, std::size_t size, int limit) {
+        long long sum = 0;
+        for (std::size_t i = 0; i < size; ++i) {
+            if (values[i] > limit) [[unlikely]] {
+                throw neko::ex::RangeError(std::string("Value out of range"), {});
+            }
+            sum += values[i];
+        }
+        return sum;
+    }
+
+    long long neko_hot_path_raise(const int *values, std::size_t size, int limit) {
+        long long sum = 0;
+        for (std::size_t i = 0; i < size; ++i) {
+            if (values[i] > limit) [[unlikely]] {
+                neko::raise<neko::ex::RangeError>("Value out of range");
+            }
+            sum += values[i];
+        }
+        return sum;
+    }
+
+}
@@ -0,0 +1,30 @@
+/**
+ * @file plugin.cpp
+ * @brief Second module for the compiled library tests
+ */
+#include "plugin.hpp"
+
+#include <neko/schema/exception.hpp>
+#include <neko/schema/throwSites.hpp>
+
+namespace neko::plugin {
+
+    namespace {
+        void count(neko::ex::ErrorKind, neko::strview, const neko::SrcLocInfo &, void *userData) noexcept {
+            ++*static_cast<int *>(userData);
+        }
+    } // namespace
+
+    neko::ex::ThrowHookId addCountingHook(int *calls) {
+        return neko::ex::addThrowHook(count, calls);
+    }
+
+    void startSampling() {
+        neko::metrics::startThrowSampling();
+    }
+
+    void constructError() {
+        neko::ex::RangeError error("plugin", neko::SrcLocInfo("plugin.cpp", 1, "constructError"));
+    }
+
+} // namespace neko::plugin
@@ -0,0 +1,42 @@
+/**
+ * @file plugin.hpp
+ * @brief Second module for the compiled library tests
+ * @details Built as its own shared library when Neko::Schema::Compiled is shared, so hooks installed and sampling
+ * started here must reach the test executable through the registries defined once in the library.
+ */
+#pragma once
+
+#include <neko/schema/throwHook.hpp>
+
+#if defined(NEKO_SCHEMA_SHARED)
+    #if defined(_WIN32)
+        #if defined(NEKO_SCHEMA_PLUGIN_EXPORTS)
+            #define NEKO_SCHEMA_PLUGIN_API __declspec(dllexport)
+        #else
+            #define NEKO_SCHEMA_PLUGIN_API __declspec(dllimport)
+        #endif
+    #else
+        #define NEKO_SCHEMA_PLUGIN_API __attribute__((visibility("default")))
+    #endif
+#else
+    #define NEKO_SCHEMA_PLUGIN_API
+#endif
+
+namespace neko::plugin {
+
+    /**
+     * @brief Install, from this module, a hook counting every construction into calls.
+     */
+    NEKO_SCHEMA_PLUGIN_API neko::ex::ThrowHookId addCountingHook(int *calls);
+
+    /**
+     * @brief Start throw site sampling from this module.
+     */
+    NEKO_SCHEMA_PLUGIN_API void startSampling();
+
+    /**
+     * @brief Construct and destroy an exception in this module, at plugin.cpp:1.
+     */
+    NEKO_SCHEMA_PLUGIN_API void constructError();
+
+} // namespace neko::plugin
@@ -0,0 +1,92 @@
+/**
+ * @file schema_no_exceptions_test.cpp
+ * @brief Test file for NekoSchema built with exceptions disabled
+ * @details This file is compiled with -fno-exceptions (or /EHs-c- on MSVC), so neko::raise reports through the failure handler.
+ * Every public header is included to check that it builds without exceptions.
+ */
+
+#include <gtest/gtest.h>
+#include <neko/schema/types.hpp>
+#include <neko/schema/srcLoc.hpp>
+#include <neko/schema/cycles.hpp>
+#include <neko/schema/exception.hpp>
+#include <neko/schema/raise.hpp>
+#include <neko/schema/parse.hpp>
+#include <neko/schema/throwHook.hpp>
+#include <neko/schema/trace.hpp>
+#include <neko/schema/latency.hpp>
+#include <neko/schema/admission.hpp>
+#include <neko/schema/stateVector.hpp>
+#include <neko/schema/mappedFile.hpp>
+#include <neko/schema/journal.hpp>
+#include <neko/schema/format.hpp>
+#include <neko/schema/config.hpp>
+#include <neko/schema/configReader.hpp>
+#include <neko/schema/throwSites.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+
+using namespace neko;
+
+#if !defined(NEKO_SCHEMA_NO_EXCEPTIONS)
+    #error "This test must be compiled with exceptions disabled"
+#endif
+
+// =============================================================================
+// Failure Handler Tests
+// =============================================================================
+
+class NoExceptionsTest : public ::testing::Test {
+protected:
+    void SetUp() override {}
+    void TearDown() override {
+        setFailureHandler(nullptr);
+    }
+};
+
+namespace {
+    void exitingHandler(const ErrorRecord &record) {
+        std::fprintf(stderr, "handled %s '%.*s' at line %u\n",
+                     neko::ex::toString(record.kind),
+                     static_cast<int>(record.message.size()), record.message.data(),
+                     static_cast<unsigned>(record.srcLoc.getLine()));
+        std::_Exit(3);
+    }
+
+    void returningHandler(const ErrorRecord &) {}
+} // namespace
+
+TEST_F(NoExceptionsTest, DefaultHandlerAborts) {
+    EXPECT_DEATH(raise<neko::ex::RangeError>("index too large"), "RangeError: index too large");
+}
+
+TEST_F(NoExceptionsTest, CustomHandlerReceivesRecord) {
+    EXPECT_EQ(setFailureHandler(exitingHandler), nullptr);
+    EXPECT_EQ(getFailureHandler(), exitingHandler);
+    EXPECT_EXIT(raise<neko::ex::FileError>("missing config", SrcLocInfo("io.cpp", 42, "load")),
+                ::testing::ExitedWithCode(3), "handled FileError 'missing config' at line 42");
+}
+
+TEST_F(NoExceptionsTest, RecordCarriesTextPosition) {
+    EXPECT_DEATH(raise<neko::ex::ParseError>(neko::TextPos{9, 2, 4}, "Invalid number"),
+                 "ParseError: Invalid number.*\n.*at offset 9 \\(line 2, column 4\\)");
+}
+
+TEST_F(NoExceptionsTest, ParseErrorsReachHandler) {
+    std::vector<uint32> values;
+    EXPECT_DEATH((void)parse::toNumbers<uint32>("1,2x", ',', values), "ParseError: Invalid character in number.*\n.*at offset 3");
+    std::vector<config::Entry> entries;
+    EXPECT_DEATH((void)config::tokenize("server.port 8080", entries), "ParseError: Expected '='");
+}
+
+TEST_F(NoExceptionsTest, ConfigViolationsReachHandler) {
+    constexpr config::Schema schema{config::field("server.port", config::FieldType::UInt16).required()};
+    const config::Entry entries[] = {{"server.port", "70000", {}}};
+    EXPECT_DEATH(schema.validateOrThrow(entries), "RangeError: Invalid config: server.port: Value out of range for uint16");
+}
+
+TEST_F(NoExceptionsTest, ReturningHandlerFallsBackToAbort) {
+    setFailureHandler(returningHandler);
+    EXPECT_DEATH(raise<neko::ex::TimeoutError>("too slow"), "TimeoutError: too slow");
+}
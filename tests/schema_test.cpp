@@ -2,10 +2,32 @@
 #include <neko/schema/types.hpp>
 #include <neko/schema/exception.hpp>
 #include <neko/schema/srcLoc.hpp>
+#include <neko/schema/parse.hpp>
+#include <neko/schema/raise.hpp>
+#include <neko/schema/throwHook.hpp>
+#include <neko/schema/trace.hpp>
+#include <neko/schema/latency.hpp>
+#include <neko/schema/throwSites.hpp>
+#include <neko/schema/admission.hpp>
+#include <neko/schema/stateVector.hpp>
+#include <neko/schema/journal.hpp>
+#include <neko/schema/format.hpp>
+#include <neko/schema/config.hpp>
+#include <neko/schema/configReader.hpp>
 
+#if defined(NEKO_SCHEMA_COMPILED)
+#include "compiled/plugin.hpp"
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <filesystem>
+#include <fstream>
 #include <string>
 #include <sstream>
 #include <stdexcept>
+#include <thread>
+#include <vector>
 
 using namespace neko;
 
@@ -241,6 +263,1278 @@ TEST_F(ExceptionTest, ExceptionInheritanceFromStdException) {
     }
 }
 
+TEST_F(ExceptionTest, ErrorKind) {
+    EXPECT_EQ(neko::ex::Exception::kind, neko::ex::ErrorKind::Exception);
+    EXPECT_EQ(neko::ex::FileError::kind, neko::ex::ErrorKind::FileError);
+    EXPECT_EQ(neko::ex::TaskRejectedError::kind, neko::ex::ErrorKind::TaskRejectedError);
+    EXPECT_STREQ(neko::ex::toString(neko::ex::ErrorKind::RangeError), "RangeError");
+    EXPECT_STREQ(neko::ex::toString(neko::ex::ErrorKind::ExternalDependencyError), "ExternalDependencyError");
+}
+
+TEST_F(ExceptionTest, RaiseThrowsMatchingClass) {
+    try {
+        neko::raise<neko::ex::RangeError>("index too large", SrcLocInfo("raise.cpp", 7, "lookup"));
+        FAIL() << "Should have thrown RangeError";
+    } catch (const neko::ex::RangeError &e) {
+        EXPECT_STREQ(e.what(), "index too large");
+        EXPECT_EQ(e.getLine(), 7u);
+        EXPECT_STREQ(e.getFunc(), "lookup");
+    }
+
+    EXPECT_THROW(neko::raise<neko::ex::ProgramExit>("bye"), neko::ex::ProgramExit);
+}
+
+TEST_F(ExceptionTest, RaiseCoversEveryClassWithCallerLocation) {
+    const auto check = []<typename ErrorType>() {
+        const neko::uint32 line = std::source_location::current().line() + 2;
+        try {
+            neko::raise<ErrorType>("cold");
+        } catch (const neko::ex::Exception &e) {
+            EXPECT_EQ(e.getKind(), ErrorType::kind);
+            EXPECT_NE(dynamic_cast<const ErrorType *>(&e), nullptr);
+            EXPECT_STREQ(e.what(), "cold");
+            // The default location is captured at the call site, not inside raise
+            EXPECT_EQ(e.getLine(), line);
+            return;
+        }
+        ADD_FAILURE() << "Should have thrown " << neko::ex::toString(ErrorType::kind);
+    };
+    [&]<typename... ErrorTypes>() { (check.template operator()<ErrorTypes>(), ...); }.template operator()<
+        neko::ex::Exception, neko::ex::ProgramExit, neko::ex::LogicError, neko::ex::ArgumentError, neko::ex::RangeError,
+        neko::ex::NotSupported, neko::ex::InvalidState, neko::ex::AssertionFailure, neko::ex::DuplicateError,
+        neko::ex::RuntimeError, neko::ex::ConfigurationError, neko::ex::ParseError, neko::ex::ConcurrencyError,
+        neko::ex::TaskRejectedError, neko::ex::PermissionDeniedError, neko::ex::TimeoutError, neko::ex::SystemError,
+        neko::ex::FileError, neko::ex::NetworkError, neko::ex::DatabaseError, neko::ex::ExternalDependencyError>();
+}
+
+TEST_F(ExceptionTest, SystemErrorCarriesErrorCode) {
+    const neko::ex::FileError plain("Disk full");
+    EXPECT_FALSE(plain.hasCode());
+    EXPECT_STREQ(plain.what(), "Disk full");
+
+    const auto code = std::make_error_code(std::errc::no_such_file_or_directory);
+    const neko::ex::FileError withContext(code, "Cannot open config");
+    EXPECT_EQ(withContext.getCode(), std::errc::no_such_file_or_directory);
+    EXPECT_EQ(std::string(withContext.what()), "Cannot open config: " + code.message());
+    EXPECT_EQ(withContext.getKind(), neko::ex::ErrorKind::FileError);
+
+    errno = ECONNREFUSED;
+    const auto network = neko::ex::NetworkError::fromErrno();
+    EXPECT_TRUE(network.hasCode());
+    EXPECT_EQ(network.getCode(), std::errc::connection_refused);
+    EXPECT_EQ(std::string(network.what()), network.getCode().message());
+
+    // Copies keep the code and the message
+    const neko::ex::SystemError &base = network;
+    const neko::ex::NetworkError copy = network;
+    EXPECT_EQ(base.getCode(), copy.getCode());
+    EXPECT_STREQ(copy.what(), network.what());
+
+    try {
+        neko::raise<neko::ex::DatabaseError>(std::make_error_code(std::errc::timed_out), "Query");
+        FAIL() << "Should have thrown DatabaseError";
+    } catch (const neko::ex::DatabaseError &e) {
+        EXPECT_EQ(e.getCode(), std::errc::timed_out);
+    }
+}
+
+TEST_F(ExceptionTest, SystemErrorWhatIsThreadSafe) {
+    const auto code = std::make_error_code(std::errc::connection_reset);
+    const std::string expected = "Peer: " + code.message();
+    for (int round = 0; round < 20; ++round) {
+        const neko::ex::NetworkError error(code, "Peer");
+        std::vector<std::thread> readers;
+        std::vector<neko::cstr> seen(4, nullptr);
+        for (std::size_t i = 0; i < seen.size(); ++i) {
+            readers.emplace_back([&, i] { seen[i] = error.what(); });
+        }
+        for (auto &reader : readers) {
+            reader.join();
+        }
+        // Every caller sees the one published buffer
+        for (const auto *text : seen) {
+            EXPECT_EQ(text, seen[0]);
+            EXPECT_EQ(std::string(text), expected);
+        }
+    }
+}
+
+// =============================================================================
+// Throw Hook Tests
+// =============================================================================
+
+class ThrowHookTest : public ::testing::Test {
+protected:
+    struct Seen {
+        int calls = 0;
+        neko::ex::ErrorKind kind = neko::ex::ErrorKind::Exception;
+        std::string message;
+        uint32 line = 0;
+    };
+
+    static void record(neko::ex::ErrorKind kind, strview message, const SrcLocInfo &srcLoc, void *userData) noexcept {
+        auto *seen = static_cast<Seen *>(userData);
+        ++seen->calls;
+        seen->kind = kind;
+        seen->message.assign(message);
+        seen->line = srcLoc.getLine();
+    }
+
+    void SetUp() override {}
+    void TearDown() override {}
+};
+
+TEST_F(ThrowHookTest, NoHooksByDefault) {
+    EXPECT_FALSE(neko::ex::hasThrowHooks());
+    neko::ex::Exception ex("Test message");
+    EXPECT_EQ(ex.getKind(), neko::ex::ErrorKind::Exception);
+}
+
+TEST_F(ThrowHookTest, HookReceivesKindMessageAndSrcLoc) {
+    Seen seen;
+    const auto id = neko::ex::addThrowHook(record, &seen);
+    EXPECT_TRUE(neko::ex::hasThrowHooks());
+
+    neko::ex::FileError error("File not found", SrcLocInfo("io.cpp", 12, "open"));
+    EXPECT_EQ(error.getKind(), neko::ex::ErrorKind::FileError);
+    EXPECT_EQ(seen.calls, 1);
+    EXPECT_EQ(seen.kind, neko::ex::ErrorKind::FileError);
+    EXPECT_EQ(seen.message, "File not found");
+    EXPECT_EQ(seen.line, 12u);
+
+    // Default messages and the TextPos constructor go through the same path
+    neko::ex::ParseError parseError(TextPos{4, 1, 5}, "Bad token");
+    EXPECT_EQ(seen.calls, 2);
+    EXPECT_EQ(seen.kind, neko::ex::ErrorKind::ParseError);
+
+    EXPECT_TRUE(neko::ex::removeThrowHook(id));
+    EXPECT_FALSE(neko::ex::removeThrowHook(id));
+    EXPECT_FALSE(neko::ex::hasThrowHooks());
+
+    neko::ex::RangeError ignored;
+    EXPECT_EQ(seen.calls, 2);
+}
+
+TEST_F(ThrowHookTest, MultipleSubscribers) {
+    Seen first;
+    Seen second;
+    const auto firstId = neko::ex::addThrowHook(record, &first);
+    const auto secondId = neko::ex::addThrowHook(record, &second);
+
+    try {
+        neko::raise<neko::ex::TimeoutError>("Too slow");
+    } catch (const neko::ex::TimeoutError &) {
+    }
+    EXPECT_EQ(first.calls, 1);
+    EXPECT_EQ(second.calls, 1);
+    EXPECT_EQ(second.kind, neko::ex::ErrorKind::TimeoutError);
+
+    neko::ex::removeThrowHook(firstId);
+    neko::ex::LogicError error;
+    EXPECT_EQ(first.calls, 1);
+    EXPECT_EQ(second.calls, 2);
+    EXPECT_EQ(second.message, "Logic error!");
+    neko::ex::removeThrowHook(secondId);
+}
+
+#if defined(NEKO_SCHEMA_COMPILED)
+TEST_F(ThrowHookTest, HooksAreSharedAcrossModules) {
+    int pluginCalls = 0;
+    Seen seen;
+    const auto pluginId = neko::plugin::addCountingHook(&pluginCalls);
+    const auto id = neko::ex::addThrowHook(record, &seen);
+    {
+        neko::ex::RangeError error("here");
+    }
+    neko::plugin::constructError();
+    EXPECT_EQ(pluginCalls, 2);
+    EXPECT_EQ(seen.calls, 2);
+
+    // Either module can remove a hook installed by the other
+    EXPECT_TRUE(neko::ex::removeThrowHook(pluginId));
+    neko::plugin::constructError();
+    EXPECT_EQ(pluginCalls, 2);
+    EXPECT_EQ(seen.calls, 3);
+    EXPECT_TRUE(neko::ex::removeThrowHook(id));
+    EXPECT_FALSE(neko::ex::hasThrowHooks());
+}
+#endif
+
+// =============================================================================
+// Parse Tests
+// =============================================================================
+
+class ParseTest : public ::testing::Test {
+protected:
+    void SetUp() override {}
+    void TearDown() override {}
+};
+
+TEST_F(ParseTest, SingleValue) {
+    EXPECT_EQ(parse::toNumber<int64>("-9223372036854775808"), INT64_MIN);
+    EXPECT_EQ(parse::toNumber<uint32>("4294967295"), 4294967295u);
+
+    uint32 value = 7;
+    EXPECT_FALSE(parse::tryToNumber<uint32>("12a", value));
+    EXPECT_EQ(value, 7u);
+    EXPECT_TRUE(parse::tryToNumber<uint32>("12", value));
+    EXPECT_EQ(value, 12u);
+}
+
+TEST_F(ParseTest, SingleValueErrorPosition) {
+    try {
+        (void)parse::toNumber<uint32>("12x4");
+        FAIL() << "Should have thrown ParseError";
+    } catch (const neko::ex::ParseError &e) {
+        EXPECT_TRUE(e.hasTextPos());
+        EXPECT_EQ(e.getTextPos().getOffset(), 2u);
+        EXPECT_EQ(e.getTextPos().getLine(), 1u);
+        EXPECT_EQ(e.getTextPos().getColumn(), 3u);
+    }
+
+    EXPECT_THROW((void)parse::toNumber<uint32>("4294967296"), neko::ex::ParseError);
+    EXPECT_THROW((void)parse::toNumber<uint32>(""), neko::ex::ParseError);
+}
+
+TEST_F(ParseTest, DigitRun) {
+    const std::string digits = "12345678901234567890123456789x";
+    EXPECT_EQ(parse::digitRun(digits.data(), digits.data() + digits.size()), 29u);
+    EXPECT_EQ(parse::digitRun(digits.data(), digits.data() + 5), 5u);
+}
+
+TEST_F(ParseTest, DelimitedValues) {
+    std::vector<int64> values;
+    EXPECT_EQ(parse::toNumbers<int64>("1,-2,3\r\n40,50000000000000,6\n", ',', values), 6u);
+    EXPECT_EQ(values, (std::vector<int64>{1, -2, 3, 40, 50000000000000, 6}));
+}
+
+TEST_F(ParseTest, DelimitedErrorPosition) {
+    std::vector<uint32> values;
+    try {
+        (void)parse::toNumbers<uint32>("1,2,3\n4,5x,6\n", ',', values);
+        FAIL() << "Should have thrown ParseError";
+    } catch (const neko::ex::ParseError &e) {
+        EXPECT_EQ(e.getTextPos().getOffset(), 9u);
+        EXPECT_EQ(e.getTextPos().getLine(), 2u);
+        EXPECT_EQ(e.getTextPos().getColumn(), 4u);
+    }
+
+    try {
+        (void)parse::toNumbers<uint32>("1,,2", ',', values);
+        FAIL() << "Should have thrown ParseError";
+    } catch (const neko::ex::ParseError &e) {
+        EXPECT_EQ(e.getTextPos().getOffset(), 2u);
+    }
+}
+
+TEST_F(ParseTest, DelimitedRejectsTrailingDelimiterAndRollsBack) {
+    std::vector<uint32> values{7};
+    try {
+        (void)parse::toNumbers<uint32>("1,2,", ',', values);
+        FAIL() << "Should have thrown ParseError";
+    } catch (const neko::ex::ParseError &e) {
+        EXPECT_EQ(e.getTextPos().getOffset(), 4u);
+    }
+    // Values parsed before the failure are removed, earlier content is kept
+    EXPECT_EQ(values, (std::vector<uint32>{7}));
+
+    EXPECT_THROW((void)parse::toNumbers<uint32>("1,2\n3,", ',', values), neko::ex::ParseError);
+    EXPECT_EQ(values.size(), 1u);
+
+    // A line break may still end the input
+    EXPECT_EQ(parse::toNumbers<uint32>("1\n2\n", '\n', values), 2u);
+}
+
+TEST_F(ParseTest, ParseErrorWithoutPosition) {
+    neko::ex::ParseError error("Parse failed");
+    EXPECT_FALSE(error.hasTextPos());
+    EXPECT_STREQ(error.what(), "Parse failed");
+}
+
+// =============================================================================
+// Trace Tests
+// =============================================================================
+
+class TraceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        std::vector<trace::SpanRecord> stale;
+        trace::drain(stale);
+        trace::setEnabled(true);
+    }
+    void TearDown() override {
+        trace::setEnabled(false);
+    }
+};
+
+TEST_F(TraceTest, DisabledSpansAreNotRecorded) {
+    trace::setEnabled(false);
+    {
+        trace::Span span("disabled");
+    }
+    std::vector<trace::SpanRecord> records;
+    EXPECT_EQ(trace::drain(records), 0u);
+}
+
+TEST_F(TraceTest, SpansRecordSiteAndTimes) {
+    {
+        trace::Span outer;
+        trace::Span inner("inner", SrcLocInfo("trace.cpp", 21, "work"));
+    }
+
+    std::vector<trace::SpanRecord> records;
+    ASSERT_EQ(trace::drain(records), 2u);
+
+    // Inner span ends first
+    EXPECT_STREQ(records[0].name, "inner");
+    EXPECT_STREQ(records[0].file, "trace.cpp");
+    EXPECT_EQ(records[0].line, 21u);
+    EXPECT_EQ(records[1].name, nullptr);
+    EXPECT_NE(records[1].func, nullptr);
+    EXPECT_NE(records[1].line, 0u);
+    for (const auto &record : records) {
+        EXPECT_LE(record.begin, record.end);
+        EXPECT_NE(record.threadId, 0u);
+    }
+    EXPECT_LE(records[1].begin, records[0].begin);
+
+    EXPECT_EQ(trace::drain(records), 0u);
+}
+
+TEST_F(TraceTest, SpansFromExitedThreadsAreDrained) {
+    std::thread worker([] {
+        trace::Span span("worker");
+    });
+    worker.join();
+    {
+        trace::Span span("main");
+    }
+
+    std::vector<trace::SpanRecord> records;
+    ASSERT_EQ(trace::drain(records), 2u);
+    EXPECT_NE(records[0].threadId, records[1].threadId);
+    EXPECT_EQ(trace::droppedCount(), 0u);
+}
+
+TEST_F(TraceTest, ExitedRingsAreRetired) {
+    // Threads whose spans were drained while they ran leave empty rings, retired by the next registration
+    for (int i = 0; i < 20; ++i) {
+        std::atomic<bool> drained{false};
+        std::thread worker([&drained] {
+            {
+                trace::Span span("churn");
+            }
+            while (!drained.load()) {
+                std::this_thread::yield();
+            }
+        });
+        std::vector<trace::SpanRecord> records;
+        while (trace::drain(records) == 0) {
+            std::this_thread::yield();
+        }
+        drained = true;
+        worker.join();
+    }
+    {
+        // The last worker's ring and possibly the main thread's
+        auto &registry = trace::detail::traceRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        EXPECT_LE(registry.rings.size(), 2u);
+    }
+
+    // Rings of exited threads with unread spans are kept until drained
+    std::thread([] { trace::Span span("unread"); }).join();
+    std::thread([] { trace::Span span("next"); }).join();
+    std::vector<trace::SpanRecord> records;
+    ASSERT_EQ(trace::drain(records), 2u);
+    EXPECT_STREQ(records[0].name, "unread");
+    EXPECT_EQ(trace::droppedCount(), 0u);
+}
+
+TEST_F(TraceTest, ChromeTraceExport) {
+    const trace::SpanRecord record{1500, 4250, "say \"hi\"", "C:\\src\\a.cpp", "f", 3, 7};
+    std::ostringstream os;
+    trace::writeChromeTrace(os, std::span<const trace::SpanRecord>(&record, 1));
+
+    const std::string json = os.str();
+    EXPECT_NE(json.find("\"traceEvents\""), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"say \\\"hi\\\"\""), std::string::npos);
+    EXPECT_NE(json.find("\"ph\":\"X\",\"ts\":1.500,\"dur\":2.750"), std::string::npos);
+    EXPECT_NE(json.find("\"tid\":7"), std::string::npos);
+    EXPECT_NE(json.find("\"file\":\"C:\\\\src\\\\a.cpp\",\"line\":3"), std::string::npos);
+}
+
+// =============================================================================
+// Latency Tests
+// =============================================================================
+
+class LatencyTest : public ::testing::Test {
+protected:
+    void SetUp() override {}
+    void TearDown() override {}
+};
+
+TEST_F(LatencyTest, BucketBounds) {
+    using metrics::Histogram;
+    for (uint64 value : {0ull, 1ull, 15ull, 16ull, 31ull, 32ull, 1000ull, 123456789ull, ~0ull}) {
+        const auto bucket = Histogram::bucketOf(value);
+        ASSERT_LT(bucket, Histogram::bucketCount);
+        EXPECT_LE(Histogram::lowerBound(bucket), value);
+        EXPECT_GE(Histogram::upperBound(bucket), value);
+    }
+    EXPECT_EQ(Histogram::bucketOf(15), 15u);
+    EXPECT_EQ(Histogram::bucketOf(~0ull), Histogram::bucketCount - 1);
+    EXPECT_EQ(Histogram::upperBound(Histogram::bucketCount - 1), ~0ull);
+}
+
+TEST_F(LatencyTest, Percentiles) {
+    metrics::Histogram histogram;
+    EXPECT_EQ(histogram.percentile(0.5), 0u);
+
+    for (uint64 i = 1; i <= 1000; ++i) {
+        histogram.record(i * 100);
+    }
+    EXPECT_EQ(histogram.count(), 1000u);
+    EXPECT_EQ(histogram.max(), 100000u);
+
+    // Within the 6.25% bucket precision
+    EXPECT_NEAR(static_cast<double>(histogram.percentile(0.50)), 50000.0, 50000.0 * 0.0625);
+    EXPECT_NEAR(static_cast<double>(histogram.percentile(0.99)), 99000.0, 99000.0 * 0.0625);
+    EXPECT_EQ(histogram.percentile(1.0), 100000u);
+
+    metrics::Histogram other;
+    other.record(7, 3);
+    histogram.merge(other);
+    EXPECT_EQ(histogram.count(), 1003u);
+    EXPECT_EQ(histogram.percentile(0.0), 7u);
+}
+
+namespace {
+    std::size_t timedFunction() {
+        NEKO_SCOPED_TIMER("timedFunction");
+        return 1;
+    }
+} // namespace
+
+TEST_F(LatencyTest, ScopedTimerPerSite) {
+    for (int i = 0; i < 10; ++i) {
+        timedFunction();
+    }
+    std::thread worker([] {
+        for (int i = 0; i < 5; ++i) {
+            timedFunction();
+        }
+    });
+    worker.join();
+
+    metrics::TimerSite manual("manual", SrcLocInfo("latency.cpp", 9, "manual"));
+    manual.record(250);
+
+    const auto sites = metrics::snapshot();
+    const auto timed = std::find_if(sites.begin(), sites.end(), [](const metrics::SiteLatency &site) {
+        return site.name != nullptr && std::string(site.name) == "timedFunction";
+    });
+    ASSERT_NE(timed, sites.end());
+    EXPECT_EQ(timed->count, 15u);
+    EXPECT_NE(timed->site.getLine(), 0u);
+    EXPECT_LE(timed->p50, timed->p99);
+    EXPECT_LE(timed->p99, timed->p999);
+    EXPECT_LE(timed->p999, timed->max);
+
+    const auto &entry = sites[manual.getId()];
+    EXPECT_EQ(entry.count, 1u);
+    EXPECT_EQ(entry.site.getLine(), 9u);
+    EXPECT_EQ(entry.max, 250u);
+    EXPECT_EQ(entry.p50, 250u);
+}
+
+TEST_F(LatencyTest, SiteConstructionAllocatesShard) {
+    std::thread([] {
+        metrics::TimerSite eager("eager", SrcLocInfo("latency.cpp", 30, "eager"));
+        // The first record of the constructing thread does not allocate
+        auto &registry = metrics::detail::latencyRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        const auto owned = std::count_if(registry.threads.begin(), registry.threads.end(), [&eager](const auto &thread) {
+            std::lock_guard<std::mutex> shardLock(thread->mutex);
+            return eager.getId() < thread->shards.size() && thread->shards[eager.getId()] != nullptr;
+        });
+        EXPECT_EQ(owned, 1);
+    }).join();
+}
+
+TEST_F(LatencyTest, ExitedThreadsAreRetired) {
+    metrics::TimerSite churn("churn", SrcLocInfo("latency.cpp", 12, "churn"));
+    for (int i = 0; i < 50; ++i) {
+        std::thread([&churn, i] { churn.record(static_cast<uint64>(100 + i)); }).join();
+    }
+
+    const auto sites = metrics::snapshot();
+    EXPECT_EQ(sites[churn.getId()].count, 50u);
+    EXPECT_EQ(sites[churn.getId()].max, 149u);
+    {
+        // Only live threads keep shards, the samples of the others moved to the retired histograms
+        auto &registry = metrics::detail::latencyRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        EXPECT_LE(registry.threads.size(), 1u);
+    }
+    // Retired samples stay in later snapshots
+    EXPECT_EQ(metrics::snapshot()[churn.getId()].count, 50u);
+}
+
+// =============================================================================
+// Throw Site Tests
+// =============================================================================
+
+class ThrowSiteTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        metrics::resetThrowSites();
+    }
+    void TearDown() override {
+        metrics::stopThrowSampling();
+        metrics::resetThrowSites();
+    }
+};
+
+TEST_F(ThrowSiteTest, SpaceSavingKeepsHeavyHitters) {
+    const SrcLocInfo hot("hot.cpp", 1, "hot");
+    const SrcLocInfo warm("warm.cpp", 2, "warm");
+    const SrcLocInfo cold1("cold.cpp", 3, "cold");
+    const SrcLocInfo cold2("cold.cpp", 4, "cold");
+
+    metrics::SpaceSaving sketch(2);
+    sketch.add(neko::ex::ErrorKind::RangeError, hot, 10, 100);
+    sketch.add(neko::ex::ErrorKind::FileError, warm, 3, 30);
+    sketch.add(neko::ex::ErrorKind::FileError, cold1, 1, 5);
+    EXPECT_EQ(sketch.size(), 2u);
+
+    auto top = sketch.top(2);
+    EXPECT_STREQ(top[0].site.getFile(), "hot.cpp");
+    EXPECT_EQ(top[0].count, 10u);
+    EXPECT_EQ(top[0].cycles, 100u);
+    // cold1 replaced warm and inherited its count as overestimation
+    EXPECT_STREQ(top[1].site.getFile(), "cold.cpp");
+    EXPECT_EQ(top[1].count, 4u);
+    EXPECT_EQ(top[1].error, 3u);
+
+    metrics::SpaceSaving other(2);
+    other.add(neko::ex::ErrorKind::RangeError, hot, 5, 50);
+    other.add(neko::ex::ErrorKind::InvalidState, cold2, 2, 20);
+    sketch.merge(other);
+    top = sketch.top(1);
+    EXPECT_EQ(top[0].count, 15u);
+    EXPECT_EQ(top[0].cycles, 150u);
+    EXPECT_LE(sketch.size(), 2u);
+}
+
+TEST_F(ThrowSiteTest, SamplesCaughtExceptions) {
+    metrics::startThrowSampling();
+    EXPECT_TRUE(metrics::isThrowSampling());
+
+    const SrcLocInfo hot("parser.cpp", 10, "parse");
+    const SrcLocInfo cold("loader.cpp", 20, "load");
+    for (int i = 0; i < 50; ++i) {
+        try {
+            throw neko::ex::ParseError("bad input", hot);
+        } catch (const neko::ex::ParseError &) {
+        }
+    }
+    try {
+        throw neko::ex::FileError("missing", cold);
+    } catch (const neko::ex::Exception &) {
+    }
+    {
+        // Copies do not count twice
+        neko::ex::RangeError original("copied", cold);
+        neko::ex::RangeError copy = original;
+    }
+
+    metrics::stopThrowSampling();
+    neko::ex::ParseError notSampled("after stop", hot);
+
+    const auto top = metrics::topThrowSites(2);
+    ASSERT_EQ(top.size(), 2u);
+    EXPECT_STREQ(top[0].site.getFile(), "parser.cpp");
+    EXPECT_EQ(top[0].kind, neko::ex::ErrorKind::ParseError);
+    EXPECT_EQ(top[0].count, 50u);
+    EXPECT_EQ(top[0].error, 0u);
+    EXPECT_GT(top[0].cycles, 0u);
+    EXPECT_STREQ(top[1].site.getFile(), "loader.cpp");
+    EXPECT_EQ(top[1].count, 2u);
+}
+
+TEST_F(ThrowSiteTest, SamplingScalesCounts) {
+    metrics::ThrowSamplerConfig config;
+    config.sampleEvery = 4;
+    metrics::startThrowSampling(config);
+    std::thread worker([] {
+        for (int i = 0; i < 40; ++i) {
+            neko::ex::TimeoutError error("slow", SrcLocInfo("net.cpp", 5, "poll"));
+        }
+    });
+    worker.join();
+    metrics::stopThrowSampling();
+
+    const auto top = metrics::topThrowSites();
+    ASSERT_EQ(top.size(), 1u);
+    EXPECT_EQ(top[0].count, 40u);
+}
+
+TEST_F(ThrowSiteTest, SharesHookSnapshot) {
+    struct Counter {
+        static void count(neko::ex::ErrorKind, strview, const SrcLocInfo &, void *userData) noexcept {
+            ++*static_cast<int *>(userData);
+        }
+    };
+
+    // Sampling alone publishes a snapshot without throw hooks
+    metrics::startThrowSampling();
+    EXPECT_NE(neko::ex::detail::throwHooks.load(), nullptr);
+    EXPECT_FALSE(neko::ex::hasThrowHooks());
+#if !defined(NEKO_SCHEMA_COMPILED)
+    EXPECT_NE(metrics::detail::localThrowSiteShard(), nullptr);
+#endif
+
+    int calls = 0;
+    const auto id = neko::ex::addThrowHook(&Counter::count, &calls);
+    {
+        neko::ex::InvalidState error("both", SrcLocInfo("state.cpp", 7, "check"));
+    }
+    EXPECT_EQ(calls, 1);
+    EXPECT_TRUE(metrics::isThrowSampling());
+    EXPECT_TRUE(neko::ex::removeThrowHook(id));
+
+    metrics::stopThrowSampling();
+    EXPECT_EQ(neko::ex::detail::throwHooks.load(), nullptr);
+    const auto top = metrics::topThrowSites();
+    ASSERT_EQ(top.size(), 1u);
+    EXPECT_STREQ(top[0].site.getFile(), "state.cpp");
+}
+
+TEST_F(ThrowSiteTest, ExitedThreadsAreRetired) {
+    metrics::startThrowSampling();
+    for (int i = 0; i < 50; ++i) {
+        std::thread([] { neko::ex::TimeoutError error("slow", SrcLocInfo("churn.cpp", 3, "poll")); }).join();
+    }
+    metrics::stopThrowSampling();
+
+    const auto top = metrics::topThrowSites();
+    ASSERT_EQ(top.size(), 1u);
+    EXPECT_EQ(top[0].count, 50u);
+#if !defined(NEKO_SCHEMA_COMPILED)
+    {
+        // Only live threads keep shards, the sites of the others moved to the retired sketch
+        auto &registry = metrics::detail::throwSiteRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        EXPECT_LE(registry.shards.size(), 1u);
+    }
+#endif
+    // Retired sites stay in later reports
+    EXPECT_EQ(metrics::topThrowSites()[0].count, 50u);
+}
+
+#if defined(NEKO_SCHEMA_COMPILED)
+TEST_F(ThrowSiteTest, SamplingIsSharedAcrossModules) {
+    neko::plugin::startSampling();
+    EXPECT_TRUE(metrics::isThrowSampling());
+    {
+        neko::ex::RangeError error("here", SrcLocInfo("tests.cpp", 1, "main"));
+    }
+    neko::plugin::constructError();
+    metrics::stopThrowSampling();
+    EXPECT_EQ(metrics::topThrowSites().size(), 2u);
+}
+#endif
+
+// =============================================================================
+// Admission Tests
+// =============================================================================
+
+class AdmissionTest : public ::testing::Test {
+protected:
+    void SetUp() override {}
+    void TearDown() override {}
+};
+
+TEST_F(AdmissionTest, PriorityThresholds) {
+    admission::Config config;
+    config.limit = 10;
+    admission::Controller controller(config);
+
+    EXPECT_EQ(controller.threshold(Priority::Low), 5u);
+    EXPECT_EQ(controller.threshold(Priority::Normal), 7u);
+    EXPECT_EQ(controller.threshold(Priority::High), 9u);
+    EXPECT_EQ(controller.threshold(Priority::Critical), 10u);
+}
+
+TEST_F(AdmissionTest, SmallLimitsReserveCritical) {
+    admission::Config config;
+    config.limit = 1;
+    admission::Controller single(config);
+    EXPECT_EQ(single.threshold(Priority::Low), 0u);
+    EXPECT_EQ(single.threshold(Priority::Normal), 0u);
+    EXPECT_EQ(single.threshold(Priority::High), 0u);
+    EXPECT_EQ(single.threshold(Priority::Critical), 1u);
+    EXPECT_FALSE(single.tryAdmit(Priority::Low));
+    {
+        auto permit = single.tryAdmit(Priority::Critical);
+        EXPECT_TRUE(permit);
+    }
+
+    config.limit = 2;
+    admission::Controller pair(config);
+    EXPECT_EQ(pair.threshold(Priority::Low), 1u);
+    EXPECT_EQ(pair.threshold(Priority::High), 1u);
+    EXPECT_EQ(pair.threshold(Priority::Critical), 2u);
+    auto low = pair.tryAdmit(Priority::Low);
+    EXPECT_TRUE(low);
+    // The last permit is left to Critical work
+    EXPECT_FALSE(pair.tryAdmit(Priority::High));
+    EXPECT_TRUE(pair.tryAdmit(Priority::Critical));
+}
+
+TEST_F(AdmissionTest, LowPriorityIsShedFirst) {
+    admission::Config config;
+    config.limit = 4;
+    admission::Controller controller(config);
+
+    std::vector<admission::Permit> permits;
+    permits.push_back(controller.tryAdmit(Priority::Low));
+    permits.push_back(controller.tryAdmit(Priority::Low));
+    EXPECT_TRUE(permits[0]);
+    EXPECT_TRUE(permits[1]);
+
+    EXPECT_FALSE(controller.tryAdmit(Priority::Low));
+    EXPECT_EQ(controller.getRejected(Priority::Low), 1u);
+
+    permits.push_back(controller.tryAdmit(Priority::Critical));
+    permits.push_back(controller.tryAdmit(Priority::Critical));
+    EXPECT_TRUE(permits[3]);
+    EXPECT_EQ(controller.getInFlight(), 4u);
+    EXPECT_FALSE(controller.tryAdmit(Priority::Critical));
+
+    EXPECT_THROW((void)controller.admit(Priority::High), neko::ex::TaskRejectedError);
+
+    permits.clear();
+    EXPECT_EQ(controller.getInFlight(), 0u);
+    EXPECT_TRUE(controller.tryAdmit(Priority::Low));
+}
+
+TEST_F(AdmissionTest, PermitReleasesOnce) {
+    admission::Controller controller;
+    auto permit = controller.admit(Priority::Normal);
+    EXPECT_EQ(controller.getInFlight(), 1u);
+
+    admission::Permit moved = std::move(permit);
+    EXPECT_FALSE(permit);
+    EXPECT_TRUE(moved);
+    EXPECT_EQ(controller.getInFlight(), 1u);
+
+    moved.release();
+    moved.release();
+    EXPECT_EQ(controller.getInFlight(), 0u);
+}
+
+TEST_F(AdmissionTest, AdaptiveLimit) {
+    admission::Config config;
+    config.limit = 10;
+    config.adaptive = true;
+    config.targetLatency = std::chrono::hours(1);
+    admission::Controller growing(config);
+    for (int i = 0; i < 10; ++i) {
+        (void)growing.tryAdmit(Priority::Normal);
+    }
+    EXPECT_EQ(growing.getLimit(), 11u);
+
+    config.targetLatency = std::chrono::nanoseconds(1);
+    admission::Controller shrinking(config);
+    {
+        auto permit = shrinking.tryAdmit(Priority::Normal);
+        std::this_thread::sleep_for(std::chrono::microseconds(10));
+    }
+    EXPECT_EQ(shrinking.getLimit(), 9u);
+}
+
+// =============================================================================
+// State Vector Tests
+// =============================================================================
+
+class StateVectorTest : public ::testing::Test {
+protected:
+    void SetUp() override {}
+    void TearDown() override {}
+};
+
+TEST_F(StateVectorTest, Packing) {
+    StateVector states(100, State::ActionNeeded);
+    EXPECT_EQ(states.size(), 100u);
+    EXPECT_EQ(states.storageBytes(), 32u);
+    EXPECT_EQ(states.get(99), State::ActionNeeded);
+
+    states.set(0, State::Failed);
+    EXPECT_EQ(states.exchange(64, State::RetryRequired), State::ActionNeeded);
+    EXPECT_EQ(states[0], State::Failed);
+    EXPECT_EQ(states[1], State::ActionNeeded);
+    EXPECT_EQ(states[64], State::RetryRequired);
+
+    State expected = State::Completed;
+    EXPECT_FALSE(states.compareExchange(2, expected, State::Failed));
+    EXPECT_EQ(expected, State::ActionNeeded);
+    EXPECT_TRUE(states.compareExchange(2, expected, State::Completed));
+    EXPECT_EQ(states[2], State::Completed);
+
+    states.resize(33);
+    states.resize(40, State::Failed);
+    EXPECT_EQ(states[32], State::ActionNeeded);
+    EXPECT_EQ(states[33], State::Failed);
+    EXPECT_EQ(states[39], State::Failed);
+}
+
+TEST_F(StateVectorTest, Kernels) {
+    StateVector states(1000);
+    states.set(5, State::ActionNeeded);
+    states.set(70, State::RetryRequired);
+    states.set(999, State::Failed);
+
+    const auto counts = states.countAll();
+    EXPECT_EQ(counts[0], 997u);
+    EXPECT_EQ(counts[1], 1u);
+    EXPECT_EQ(states.count(State::RetryRequired), 1u);
+    EXPECT_EQ(states.count(State::Failed), 1u);
+
+    EXPECT_EQ(states.findNextFailure(), 70u);
+    EXPECT_EQ(states.findNextFailure(71), 999u);
+    EXPECT_EQ(states.findNextFailure(1000), StateVector::npos);
+    EXPECT_EQ(states.findNext(State::ActionNeeded), 5u);
+    EXPECT_EQ(states.findNext(State::ActionNeeded, 6), StateVector::npos);
+    // Padding lanes of the last word are not reported as Completed
+    EXPECT_EQ(states.findNext(State::Completed, 999), StateVector::npos);
+}
+
+TEST_F(StateVectorTest, MergeKeepsWorstState) {
+    StateVector first(64);
+    StateVector second(64);
+    first.set(0, State::Failed);
+    second.set(0, State::ActionNeeded);
+    first.set(1, State::ActionNeeded);
+    second.set(1, State::RetryRequired);
+    second.set(2, State::ActionNeeded);
+
+    first.merge(second);
+    EXPECT_EQ(first[0], State::Failed);
+    EXPECT_EQ(first[1], State::RetryRequired);
+    EXPECT_EQ(first[2], State::ActionNeeded);
+    EXPECT_EQ(first[3], State::Completed);
+
+    EXPECT_THROW(first.merge(StateVector(10)), neko::ex::ArgumentError);
+}
+
+// =============================================================================
+// Config Schema Tests
+// =============================================================================
+
+class ConfigTest : public ::testing::Test {
+protected:
+    static constexpr config::Schema schema{
+        config::field("server.port", config::FieldType::UInt16).required().range(1024, 65535),
+        config::field("server.host", config::FieldType::String).required(),
+        config::field("queue.priority", config::FieldType::Priority),
+        config::field("queue.depth", config::FieldType::Int8),
+        config::field("debug", config::FieldType::Bool),
+    };
+
+    void SetUp() override {}
+    void TearDown() override {}
+};
+
+TEST_F(ConfigTest, PlanIsSortedAtCompileTime) {
+    static_assert(schema.size() == 5);
+    static_assert(schema[0].key == "debug");
+    static_assert(schema.find("server.port") == 4);
+    static_assert(schema.find("missing") == 5);
+    EXPECT_TRUE(schema[schema.find("server.host")].isRequired);
+
+    // A constexpr schema with duplicate keys does not compile, at runtime it throws
+    EXPECT_THROW(config::Schema(config::field("a", config::FieldType::Bool), config::field("a", config::FieldType::Bool)),
+                 neko::ex::ArgumentError);
+}
+
+TEST_F(ConfigTest, ValidDocument) {
+    const std::vector<config::Entry> entries = {
+        {"server.host", "localhost"},
+        {"server.port", "8080"},
+        {"queue.priority", "High"},
+        {"debug", "true"},
+    };
+    std::vector<config::Violation> violations;
+    EXPECT_EQ(schema.validate(entries, violations), 0u);
+    EXPECT_NO_THROW(schema.validateOrThrow(entries));
+}
+
+TEST_F(ConfigTest, CollectsEveryViolation) {
+    const std::vector<config::Entry> entries = {
+        {"server.port", "80", TextPos{0, 1, 1}},
+        {"queue.priority", "Urgent", TextPos{20, 2, 1}},
+        {"queue.depth", "300", TextPos{40, 3, 1}},
+        {"debug", "true"},
+        {"debug", "false"},
+        {"colour", "blue"},
+    };
+    std::vector<config::Violation> violations;
+    ASSERT_EQ(schema.validate(entries, violations), 6u);
+
+    EXPECT_EQ(violations[0].path, "server.port");
+    EXPECT_EQ(violations[0].message, "Value out of range [1024, 65535]");
+    EXPECT_EQ(violations[0].kind, neko::ex::ErrorKind::RangeError);
+    EXPECT_EQ(violations[0].pos.getLine(), 1u);
+
+    EXPECT_EQ(violations[1].message, "Expected Priority");
+    EXPECT_EQ(violations[1].kind, neko::ex::ErrorKind::ConfigurationError);
+    EXPECT_EQ(violations[2].message, "Value out of range for int8");
+    EXPECT_EQ(violations[2].kind, neko::ex::ErrorKind::RangeError);
+    EXPECT_EQ(violations[3].message, "Duplicate key");
+    EXPECT_EQ(violations[4].path, "colour");
+    EXPECT_EQ(violations[4].message, "Unknown key");
+    EXPECT_EQ(violations[5].path, "server.host");
+    EXPECT_EQ(violations[5].message, "Missing required key");
+
+    violations.clear();
+    EXPECT_EQ(schema.validate(entries, violations, true), 5u);
+}
+
+TEST_F(ConfigTest, ValidateOrThrowPicksErrorClass) {
+    const std::vector<config::Entry> outOfRange = {
+        {"server.host", "localhost"},
+        {"server.port", "70000", TextPos{12, 2, 1}},
+    };
+    try {
+        schema.validateOrThrow(outOfRange);
+        FAIL() << "Should have thrown RangeError";
+    } catch (const neko::ex::RangeError &e) {
+        EXPECT_STREQ(e.what(), "Invalid config: server.port: Value out of range for uint16 (line 2)");
+    }
+
+    const std::vector<config::Entry> mixed = {
+        {"server.port", "70000"},
+        {"server.host", "localhost"},
+        {"debug", "maybe"},
+    };
+    EXPECT_THROW(schema.validateOrThrow(mixed), neko::ex::ConfigurationError);
+}
+
+TEST_F(ConfigTest, TokenizeWithoutCopies) {
+    const std::string text = "# tenant\r\n  server.host =  localhost \r\n\n; note\nserver.port=8080\nempty =\n";
+    std::vector<config::Entry> entries;
+    ASSERT_EQ(config::tokenize(text, entries), 3u);
+
+    EXPECT_EQ(entries[0].key, "server.host");
+    EXPECT_EQ(entries[0].value, "localhost");
+    EXPECT_EQ(entries[0].pos.getLine(), 2u);
+    EXPECT_EQ(entries[0].pos.getColumn(), 3u);
+    EXPECT_EQ(entries[0].pos.getOffset(), 12u);
+    EXPECT_GE(entries[0].value.data(), text.data());
+    EXPECT_LT(entries[0].value.data(), text.data() + text.size());
+
+    EXPECT_EQ(entries[1].key, "server.port");
+    EXPECT_EQ(entries[1].value, "8080");
+    EXPECT_EQ(entries[1].pos.getLine(), 5u);
+    EXPECT_EQ(entries[2].value, "");
+}
+
+TEST_F(ConfigTest, TokenizeRaisesPositionedParseError) {
+    std::vector<config::Entry> entries;
+    try {
+        config::tokenize("a = 1\n  missing equals\n", entries);
+        FAIL() << "Should have thrown ParseError";
+    } catch (const neko::ex::ParseError &e) {
+        EXPECT_STREQ(e.what(), "Expected '='");
+        EXPECT_EQ(e.getTextPos().getOffset(), 8u);
+        EXPECT_EQ(e.getTextPos().getLine(), 2u);
+        EXPECT_EQ(e.getTextPos().getColumn(), 3u);
+    }
+    EXPECT_THROW(config::tokenize(" = 1", entries), neko::ex::ParseError);
+    EXPECT_THROW(config::tokenize("bad key = 1", entries), neko::ex::ParseError);
+}
+
+TEST_F(ConfigTest, LoadMappedDocument) {
+    const auto path = (std::filesystem::temp_directory_path() / "neko_schema_config_test.conf").string();
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << "server.host = localhost\nserver.port = 70000\nqueue.priority = Critical\n";
+    }
+
+    auto document = config::Document::load(path);
+    ASSERT_EQ(document.size(), 3u);
+    ASSERT_NE(document.find("server.port"), nullptr);
+    EXPECT_EQ(document.find("server.port")->value, "70000");
+    EXPECT_EQ(document.find("absent"), nullptr);
+    EXPECT_EQ(document.getEntries()[0].key.data(), document.getText().data());
+
+    const auto owned = document.toOwned();
+    document = config::Document();
+    EXPECT_EQ(owned[2].key, "queue.priority");
+    EXPECT_EQ(owned[2].value, "Critical");
+
+    EXPECT_THROW(schema.validateOrThrow(config::Document::load(path).getEntries()), neko::ex::RangeError);
+
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << "ok = 1\nbroken\n";
+    }
+    try {
+        (void)config::Document::load(path);
+        FAIL() << "Should have thrown ParseError";
+    } catch (const neko::ex::ParseError &e) {
+        EXPECT_EQ(std::string(e.what()), path + ": Expected '='");
+        EXPECT_EQ(e.getTextPos().getLine(), 2u);
+    }
+    std::filesystem::remove(path);
+
+    try {
+        (void)config::Document::load(path);
+        FAIL() << "Should have thrown FileError";
+    } catch (const neko::ex::FileError &e) {
+        EXPECT_EQ(e.getCode(), std::errc::no_such_file_or_directory);
+    }
+}
+
+// =============================================================================
+// Journal Tests
+// =============================================================================
+
+class JournalTest : public ::testing::Test {
+protected:
+    std::string path;
+
+    void SetUp() override {
+        path = (std::filesystem::temp_directory_path() / "neko_schema_journal_test.bin").string();
+        std::filesystem::remove(path);
+    }
+    void TearDown() override {
+        std::filesystem::remove(path);
+    }
+};
+
+TEST_F(JournalTest, RecordsAttachedExceptions) {
+    journal::Journal errors(path, 8);
+    errors.attach();
+    EXPECT_TRUE(errors.isAttached());
+
+    neko::ex::FileError fileError("Cannot read config", {"config.cpp", 12, "load"});
+    neko::ex::RangeError rangeError(std::string(300, 'x'));
+    errors.detach();
+    neko::ex::RuntimeError ignored("Not journaled");
+
+    const auto records = errors.records();
+    ASSERT_EQ(records.size(), 2u);
+    EXPECT_EQ(records[0].seq, 0u);
+    EXPECT_EQ(records[0].kind, neko::ex::ErrorKind::FileError);
+    EXPECT_EQ(records[0].message, "Cannot read config");
+    EXPECT_EQ(records[0].file, "config.cpp");
+    EXPECT_EQ(records[0].func, "load");
+    EXPECT_EQ(records[0].line, 12u);
+    EXPECT_FALSE(records[0].truncated);
+    EXPECT_GT(records[0].timestampNs, 0u);
+
+    EXPECT_EQ(records[1].kind, neko::ex::ErrorKind::RangeError);
+    EXPECT_TRUE(records[1].truncated);
+    EXPECT_EQ(records[1].message, std::string(120, 'x'));
+}
+
+TEST_F(JournalTest, RingKeepsNewestRecords) {
+    {
+        journal::Journal errors(path, 4);
+        for (int i = 0; i < 10; ++i) {
+            errors.append(neko::ex::ErrorKind::TimeoutError, std::to_string(i));
+        }
+        EXPECT_EQ(errors.appended(), 10u);
+    }
+
+    // Decoded from the file, as a post-mortem tool would
+    const auto records = journal::read(path);
+    ASSERT_EQ(records.size(), 4u);
+    for (std::size_t i = 0; i < records.size(); ++i) {
+        EXPECT_EQ(records[i].seq, 6 + i);
+        EXPECT_EQ(records[i].message, std::to_string(6 + i));
+    }
+
+    // Reopening keeps the records and continues the sequence
+    journal::Journal reopened(path, 4);
+    reopened.append(neko::ex::ErrorKind::TimeoutError, "10");
+    EXPECT_EQ(reopened.records().back().seq, 10u);
+}
+
+TEST_F(JournalTest, ConcurrentAppends) {
+    journal::Journal errors(path, 1024);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&errors] {
+            for (int i = 0; i < 100; ++i) {
+                errors.append(neko::ex::ErrorKind::ConcurrencyError, "race");
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    const auto records = errors.records();
+    ASSERT_EQ(records.size(), 400u);
+    for (std::size_t i = 0; i < records.size(); ++i) {
+        EXPECT_EQ(records[i].seq, i);
+    }
+}
+
+TEST_F(JournalTest, ReadRejectsInvalidFiles) {
+    try {
+        (void)journal::read(path);
+        FAIL() << "Should have thrown FileError";
+    } catch (const neko::ex::FileError &e) {
+        EXPECT_EQ(e.getCode(), std::errc::no_such_file_or_directory);
+    }
+    {
+        std::FILE *file = std::fopen(path.c_str(), "wb");
+        std::fputs("not a journal", file);
+        std::fclose(file);
+    }
+    EXPECT_THROW(journal::read(path), neko::ex::ParseError);
+}
+
+TEST_F(JournalTest, RejectsCorruptSlotCount) {
+    {
+        journal::Journal errors(path, 1);
+        errors.append(neko::ex::ErrorKind::FileError, "ok");
+    }
+    {
+        // Valid magic and version, slot count far beyond the file size (its mapping size would overflow)
+        auto file = MappedFile::openWrite(path, sizeof(journal::detail::FileHeader) + sizeof(journal::detail::Slot));
+        reinterpret_cast<journal::detail::FileHeader *>(file.data())->slotCount = neko::uint64{1} << 56;
+    }
+    EXPECT_THROW(journal::read(path), neko::ex::ParseError);
+    EXPECT_THROW(journal::Journal(path, 1), neko::ex::ParseError);
+}
+
+TEST_F(JournalTest, KeepsForeignFilesAndExistingSlotCount) {
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << "important data";
+    }
+    EXPECT_THROW(journal::Journal(path, 2), neko::ex::ParseError);
+    {
+        std::ifstream file(path, std::ios::binary);
+        const std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        EXPECT_EQ(content, "important data");
+    }
+
+    std::filesystem::remove(path);
+    {
+        journal::Journal errors(path, 4);
+        errors.append(neko::ex::ErrorKind::FileError, "previous run");
+    }
+    // A different configured slot count adopts the file's, the records survive
+    journal::Journal reopened(path, 16);
+    EXPECT_EQ(reopened.capacity(), 4u);
+    ASSERT_EQ(reopened.records().size(), 1u);
+    EXPECT_EQ(reopened.records()[0].message, "previous run");
+}
+
+TEST_F(JournalTest, BusySlotsAreNeverTorn) {
+    journal::Journal errors(path, 2);
+    {
+        // Another writer still owns slot 0, as when the ring wraps onto an unfinished record
+        auto file = MappedFile::openWrite(path, journal::detail::mappingSize(2));
+        reinterpret_cast<journal::detail::Slot *>(file.data() + sizeof(journal::detail::FileHeader))[0].commit = journal::detail::busy;
+    }
+    errors.append(neko::ex::ErrorKind::FileError, "dropped");
+    errors.append(neko::ex::ErrorKind::FileError, "kept");
+    EXPECT_EQ(errors.dropped(), 1u);
+    ASSERT_EQ(errors.records().size(), 1u);
+    EXPECT_EQ(errors.records()[0].message, "kept");
+
+    // A slot left busy by a crashed writer is released on reopen
+    journal::Journal reopened(path, 2);
+    reopened.append(neko::ex::ErrorKind::FileError, "after crash");
+    EXPECT_EQ(reopened.records().size(), 2u);
+}
+
+TEST_F(JournalTest, DetachWaitsForRunningHooks) {
+    std::atomic<bool> stop{false};
+    std::thread thrower([&stop] {
+        while (!stop.load(std::memory_order_relaxed)) {
+            neko::ex::RuntimeError error("background");
+        }
+    });
+    // Unmapping while the other thread is still inside the hook would crash
+    for (int i = 0; i < 50; ++i) {
+        journal::Journal errors(path, 64);
+        errors.attach();
+        std::this_thread::yield();
+    }
+    stop.store(true);
+    thrower.join();
+}
+
+// =============================================================================
+// Format Tests
+// =============================================================================
+
+class FormatTest : public ::testing::Test {
+protected:
+    void SetUp() override {}
+    void TearDown() override {}
+};
+
+// Used by the formatters, available without <format>
+TEST_F(FormatTest, SyncModeToString) {
+    EXPECT_STREQ(toString(SyncMode::Sync), "Sync");
+    EXPECT_STREQ(toString(SyncMode::Async), "Async");
+}
+
+#if NEKO_SCHEMA_HAS_FORMAT
+
+TEST_F(FormatTest, SrcLocInfo) {
+    const SrcLocInfo loc("main.cpp", 42, "run");
+    EXPECT_EQ(std::format("{}", loc), "main.cpp:42");
+    EXPECT_EQ(std::format("{:f}", loc), "main.cpp:42 in run");
+}
+
+TEST_F(FormatTest, Enums) {
+    EXPECT_EQ(std::format("{}", State::RetryRequired), "RetryRequired");
+    EXPECT_EQ(std::format("{}", Priority::High), "High");
+    EXPECT_EQ(std::format("{}", SyncMode::Async), "Async");
+    EXPECT_EQ(std::format("[{:>6}]", Priority::Low), "[   Low]");
+    EXPECT_EQ(std::format("{}", neko::ex::ErrorKind::FileError), "FileError");
+}
+
+TEST_F(FormatTest, Exceptions) {
+    const neko::ex::RangeError error("index 7", {"vec.cpp", 10, "at"});
+    EXPECT_EQ(std::format("{}", error), "RangeError: index 7");
+    EXPECT_EQ(std::format("{:f}", error), "RangeError: index 7 (at vec.cpp:10 in at)");
+
+    const neko::ex::Exception &base = error;
+    EXPECT_EQ(std::format("{}", base), "RangeError: index 7");
+
+    // Formatting into a caller-owned buffer
+    char buffer[64];
+    const auto result = std::format_to_n(buffer, sizeof(buffer), "{}", error);
+    EXPECT_EQ(std::string_view(buffer, result.out), "RangeError: index 7");
+}
+
+TEST_F(FormatTest, CauseChain) {
+    try {
+        try {
+            throw neko::ex::FileError("Cannot open", {"io.cpp", 3, "open"});
+        } catch (...) {
+            std::throw_with_nested(neko::ex::ConfigurationError("Config unavailable", {"cfg.cpp", 8, "load"}));
+        }
+    } catch (const neko::ex::ConfigurationError &e) {
+        EXPECT_EQ(std::format("{:c}", e), "ConfigurationError: Config unavailable; caused by: FileError: Cannot open");
+        EXPECT_EQ(std::format("{:fc}", e),
+                  "ConfigurationError: Config unavailable (at cfg.cpp:8 in load); caused by: FileError: Cannot open (at io.cpp:3 in open)");
+    }
+}
+
+#endif // NEKO_SCHEMA_HAS_FORMAT
+
 // =============================================================================
 // Integration Tests
 // =============================================================================